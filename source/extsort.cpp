@@ -0,0 +1,141 @@
+/**
+ * End-to-end benchmark of the external-memory sort.
+ *
+ * g++ -Wall -pedantic -std=c++17 -O2 -pthread -o bin/extsort source/extsort.cpp -ltbb
+ * (drop -ltbb when TBB is not installed; the parallel baselines then run serially)
+ *
+ * ./bin/extsort gen data/input.bin 50000000
+ *   Writes 50000000 random values to data/input.bin.
+ * ./bin/extsort sort data/input.bin data/output.bin 64 16 /tmp
+ *   Sorts with a 64 MiB memory budget, runs sorted by the algorithm with bit code 16 (quick),
+ *   temporary runs under /tmp.
+ */
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdio>
+#include <stdexcept>
+
+#include "lib/sorting.h"
+#include "lib/external_sort.h"
+#include "lib/ClassSortingCollection.h"
+
+
+using value_type = long int;
+
+
+constexpr short PRECISION = 2;
+
+
+struct RunningOpt{
+    std::string input{"data/input.bin"};    //!< File to sort.
+    std::string output{"data/output.bin"};  //!< Sorted file.
+    std::string tmp_dir{"data"};            //!< Directory for the temporary runs.
+    size_t memory_mb{64};                   //!< Memory budget in MiB.
+    short which_alg{16};                    //!< Bit code of the algorithm that sorts each run.
+};
+
+
+constexpr bool compare( const value_type &a, const value_type &b ){
+    return ( a < b );
+}
+
+
+/// Writes `n_values` random values to `path`.
+void generate( const std::string &path, size_t n_values )
+{
+    es::File out = es::open_file( path, "wb" );
+    std::mt19937_64 rng( 42 );
+    std::uniform_int_distribution<value_type> dist( 0, static_cast<value_type>( n_values ) * 4 );
+
+    std::vector<value_type> buffer( 1 << 16 );
+    while ( n_values > 0 )
+    {
+        size_t len = std::min( n_values, buffer.size() );
+        for ( size_t i = 0; i < len; i++ )
+            buffer[i] = dist( rng );
+        std::fwrite( buffer.data(), sizeof(value_type), len, out.get() );
+        n_values -= len;
+    }
+}
+
+
+/// Streams through `path` and checks that it is in non-descending order.
+bool is_sorted_file( const std::string &path )
+{
+    es::File in = es::open_file( path, "rb" );
+    std::vector<value_type> buffer( 1 << 16 );
+    bool has_prev = false;
+    value_type prev = 0;
+    size_t len;
+    while ( ( len = std::fread( buffer.data(), sizeof(value_type), buffer.size(), in.get() ) ) > 0 )
+    {
+        for ( size_t i = 0; i < len; i++ )
+        {
+            if ( has_prev and compare( buffer[i], prev ) )
+                return false;
+            prev = buffer[i];
+            has_prev = true;
+        }
+    }
+    return true;
+}
+
+
+int main( int argc, char * argv[] ){
+    std::string mode = argc > 1 ? argv[1] : "";
+
+    if ( mode == "gen" and argc > 3 )
+    {
+        generate( argv[2], std::stoul(argv[3]) );
+        return 0;
+    }
+
+    if ( mode != "sort" )
+    {
+        std::cerr << "usage: " << argv[0] << " gen <file> <n_values>\n"
+                  << "       " << argv[0] << " sort <input> <output> [memory_mb] [alg_bit] [tmp_dir]\n";
+        return 1;
+    }
+
+    RunningOpt run_opt;
+    if ( argc > 2 )
+        run_opt.input = argv[2];
+    if ( argc > 3 )
+        run_opt.output = argv[3];
+    if ( argc > 4 )
+        run_opt.memory_mb = std::stoul(argv[4]);
+    if ( argc > 5 )
+        run_opt.which_alg = std::stoi(argv[5]);
+    if ( argc > 6 )
+        run_opt.tmp_dir = argv[6];
+
+    using MyIt = std::vector<value_type>::iterator;
+    SortingCollection<value_type, MyIt, bool (*)(const value_type&, const value_type&)> sort_algs{ run_opt.which_alg };
+    if ( sort_algs.has_ended() )
+    {
+        std::cerr << "no algorithm selected by bit code " << run_opt.which_alg << "\n";
+        return 1;
+    }
+
+    es::ExternalStats stats;
+    try {
+        stats = es::sort<value_type>( run_opt.input, run_opt.output, run_opt.tmp_dir,
+                                      run_opt.memory_mb << 20, sort_algs.algorithm(), compare );
+    }
+    catch ( const std::runtime_error &e ) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    std::cout << "algorithm,memory_mb,bytes,runs,merge_passes,run_seconds,merge_seconds,mb_per_s,sorted\n"
+              << sort_algs.name() << "," << run_opt.memory_mb << "," << stats.bytes << ","
+              << stats.runs << "," << stats.merge_passes << ","
+              << std::fixed << std::setprecision(PRECISION)
+              << stats.run_seconds << "," << stats.merge_seconds << "," << stats.throughput_mbs() << ","
+              << ( is_sorted_file( run_opt.output ) ? "yes" : "no" ) << "\n";
+
+    return 0;
+}
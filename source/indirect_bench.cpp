@@ -0,0 +1,158 @@
+/**
+ * Compares direct sorting of records against indirect (key + index) sorting
+ * as the record size grows.
+ *
+ * g++ -Wall -pedantic -std=c++17 -O2 -o bin/indirectBench source/indirect_bench.cpp -ltbb
+ * (drop -ltbb when TBB is not installed; the parallel baselines then run serially)
+ *
+ * ./bin/indirectBench 10000 56 3
+ *   argv[1] number of records, argv[2] bit code for the algorithms, argv[3] runs per cell.
+ *   Radix (64) has no direct column, since records have no arithmetic.
+ */
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cassert>
+#include <algorithm>
+
+#include "lib/sorting.h"
+#include "lib/indirect.h"
+#include "lib/ClassSortingCollection.h"
+
+
+using key_type = long int;
+using duration_t = std::chrono::duration<double>;
+
+
+constexpr short PRECISION = 2;
+
+
+struct RunningOpt{
+    size_t n_records{10000};  //!< Number of records per sort.
+    short which_algs{56};     //!< Bit code for the chosen algorithms to run (shell, quick and merge).
+    short n_runs{3};          //!< Number of rounds for each cell.
+};
+
+
+/// A record with a key followed by `Size - sizeof(key_type)` bytes of payload.
+template < size_t Size >
+struct Record {
+    static_assert( Size > sizeof(key_type), "record must be larger than its key" );
+
+    key_type key;
+    char payload[Size - sizeof(key_type)];
+
+    bool operator<( const Record &other ) const { return key < other.key; }
+};
+
+template < size_t Size >
+bool compare_records( const Record<Size> &a, const Record<Size> &b ){
+    return ( a.key < b.key );
+}
+
+
+/*!
+ * Runs every selected algorithm on records of `Size` bytes, once sorting the records
+ * directly and once through `sa::indirect`, and appends one CSV line per algorithm.
+ */
+template < size_t Size >
+void bench_record_size( const RunningOpt &run_opt, std::ostream &out )
+{
+    using record_t = Record<Size>;
+    using RecordIt = typename std::vector<record_t>::iterator;
+
+    std::vector<record_t> original( run_opt.n_records );
+    std::mt19937_64 rng( 42 );
+    std::uniform_int_distribution<key_type> dist( 0, static_cast<key_type>( run_opt.n_records ) * 4 );
+    for ( auto &r : original )
+    {
+        r.key = dist( rng );
+        std::fill( std::begin(r.payload), std::end(r.payload), static_cast<char>( r.key ) );
+    }
+
+    std::vector<record_t> work( original.size() );
+    auto key_of = []( const record_t &r ){ return r.key; };
+
+    SortingCollection<record_t, RecordIt, bool (*)(const record_t&, const record_t&)> direct_algs{ run_opt.which_algs };
+    SortingCollection<sa::packed_t, sa::PackedIt, sa::PackedCompare> packed_algs{ run_opt.which_algs };
+
+    direct_algs.start();
+    packed_algs.start();
+
+    // FOR EACH SORTING ALGORITHM DO...
+    while ( not packed_algs.has_ended() )
+    {
+        // Radix only runs indirectly (records have no arithmetic), so it gets no direct column.
+        bool has_direct = not direct_algs.has_ended() and direct_algs.name() == packed_algs.name();
+
+        duration_t direct_mean{0.0}, indirect_mean{0.0};
+
+        for ( auto ct_run(0) ; ct_run < run_opt.n_runs ; ++ct_run )
+        {
+            if ( has_direct )
+            {
+                std::copy( original.begin(), original.end(), work.begin() );
+                auto start = std::chrono::steady_clock::now();
+                direct_algs.algorithm()( work.begin(), work.end(), compare_records<Size> );
+                auto end = std::chrono::steady_clock::now();
+                direct_mean = direct_mean + ( (end - start) - direct_mean ) / static_cast<double>(ct_run+1);
+                assert( std::is_sorted( work.begin(), work.end(), compare_records<Size> ) );
+            }
+
+            std::copy( original.begin(), original.end(), work.begin() );
+            auto start = std::chrono::steady_clock::now();
+            sa::indirect( work.begin(), work.end(), key_of, packed_algs.algorithm() );
+            auto end = std::chrono::steady_clock::now();
+            indirect_mean = indirect_mean + ( (end - start) - indirect_mean ) / static_cast<double>(ct_run+1);
+            assert( std::is_sorted( work.begin(), work.end(), compare_records<Size> ) );
+        }
+
+        double direct_ns = std::chrono::duration<double, std::nano>(direct_mean).count();
+        double indirect_ns = std::chrono::duration<double, std::nano>(indirect_mean).count();
+
+        out << Size << "," << packed_algs.name() << "," << std::fixed << std::setprecision(PRECISION);
+        if ( has_direct )
+            out << direct_ns << "," << indirect_ns << "," << direct_ns / indirect_ns << "\n";
+        else
+            out << "," << indirect_ns << ",\n";
+
+        if ( has_direct )
+            direct_algs.next();
+        packed_algs.next();
+    }
+}
+
+
+int main( int argc, char * argv[] ){
+    RunningOpt run_opt;
+
+    if ( argc > 1 )
+        run_opt.n_records = std::stoul(argv[1]);
+    if ( argc > 2 )
+        run_opt.which_algs = std::stoi(argv[2]);
+    if ( argc > 3 )
+        run_opt.n_runs = std::stoi(argv[3]);
+
+    std::stringstream bodyFile;
+    bodyFile << "record_bytes,algorithm,direct,indirect,speedup\n";
+
+    // FOR EACH RECORD SIZE DO...
+    bench_record_size<16>( run_opt, bodyFile );
+    bench_record_size<64>( run_opt, bodyFile );
+    bench_record_size<256>( run_opt, bodyFile );
+    bench_record_size<1024>( run_opt, bodyFile );
+    bench_record_size<4096>( run_opt, bodyFile );
+
+    std::ofstream file( "data/indirect.csv" );
+    file << bodyFile.str();
+    file.close();
+
+    std::cout << bodyFile.str();
+
+    return 0;
+}
@@ -1,10 +1,13 @@
 #ifndef DATA_SCENARIOS_H
 #define DATA_SCENARIOS_H
 
+#include <numeric>
 #include <utility>
 #include <vector>
 
 #include "ClassSortingCollection.h"
+#include "allocator.h"
+#include "trace.h"
 #include "scenarios.h"
 
 
@@ -14,12 +17,13 @@ class DataScenarios {
         size_t max_sample_sz;
         size_t min_sample_sz;
 
-        std::vector<DataType> data;
-        std::vector<DataType> data_copy;
-        typename std::vector<DataType>::iterator first_copy, last_copy;
+        // Both buffers follow the ba:: allocation policy active at construction.
+        ba::vector<DataType> data;
+        ba::vector<DataType> data_copy;
+        typename ba::vector<DataType>::iterator first_copy, last_copy;
         DataType *first, *last;
 
-        using DataIt = typename std::vector<DataType>::iterator;
+        using DataIt = typename ba::vector<DataType>::iterator;
         using value_t = DataType;
         using ScenariosFuncType = void (*)(value_t *, value_t *);
         using MapItem = std::pair<std::string, ScenariosFuncType>;
@@ -28,6 +32,8 @@ class DataScenarios {
         typename std::vector<MapItem>::iterator m_curr_scenery;
 
     public:
+        using iterator = DataIt;
+
         enum scenarios_t {
             NOTDECREASING = 1,
             NOTGROWING = 2,
@@ -35,7 +41,15 @@ class DataScenarios {
             _75PERINDEFINITIVEPOSITION = 8,
             _50PERINDEFINITIVEPOSITION = 16,
             _25PERINDEFINITIVEPOSITION = 32,
-            ALL_SCENARIOS = 63,
+            FEW_UNIQUE = 64,
+            ALL_EQUAL = 128,
+            ZIPF = 256,
+            SAWTOOTH = 512,
+            ORGAN_PIPE = 1024,
+            RANDOM_FULL_RANGE = 2048,
+            RANDOM_TAIL = 4096,
+            MEDIAN_OF_3_KILLER = 8192,
+            ALL_SCENARIOS = 16383,
         };
 
     public:
@@ -59,9 +73,36 @@ class DataScenarios {
             if ( selected_scenarios & _25PERINDEFINITIVEPOSITION)
                 m_scenarios.push_back(std::make_pair<std::string, ScenariosFuncType>("_25perInDefinitivePosition", sc::_25perInDefinitivePosition));
 
+            if ( selected_scenarios & FEW_UNIQUE)
+                m_scenarios.push_back(std::make_pair<std::string, ScenariosFuncType>("fewUnique", sc::fewUnique));
+
+            if ( selected_scenarios & ALL_EQUAL)
+                m_scenarios.push_back(std::make_pair<std::string, ScenariosFuncType>("allEqual", sc::allEqual));
+
+            if ( selected_scenarios & ZIPF)
+                m_scenarios.push_back(std::make_pair<std::string, ScenariosFuncType>("zipf", sc::zipf));
+
+            if ( selected_scenarios & SAWTOOTH)
+                m_scenarios.push_back(std::make_pair<std::string, ScenariosFuncType>("sawtooth", sc::sawtooth));
+
+            if ( selected_scenarios & ORGAN_PIPE)
+                m_scenarios.push_back(std::make_pair<std::string, ScenariosFuncType>("organPipe", sc::organPipe));
+
+            if ( selected_scenarios & RANDOM_FULL_RANGE)
+                m_scenarios.push_back(std::make_pair<std::string, ScenariosFuncType>("randomFullRange", sc::randomFullRange));
+
+            if ( selected_scenarios & RANDOM_TAIL)
+                m_scenarios.push_back(std::make_pair<std::string, ScenariosFuncType>("randomTail", sc::randomTail));
+
+            if ( selected_scenarios & MEDIAN_OF_3_KILLER)
+                m_scenarios.push_back(std::make_pair<std::string, ScenariosFuncType>("medianOf3Killer", sc::medianOf3Killer));
+
             m_curr_scenery = m_scenarios.begin();
 
-            size_t data_size = m_max_sample_sz - m_min_sample_sz;
+            max_sample_sz = m_max_sample_sz;
+            min_sample_sz = m_min_sample_sz;
+
+            size_t data_size = m_max_sample_sz;
             data.resize(data_size);
             data_copy.resize(data_size);
 
@@ -88,12 +129,19 @@ class DataScenarios {
         }
 
         void reset( void ) {
+            tr::Span span( "reset", "data" );
             std::copy(data.begin(), data.end(), data_copy.begin());
         }
 
         void resetPointers(){
             first_copy = data_copy.begin();
-            first = &*data_copy.begin();
+            first = &*data.begin();
+        }
+
+        /// Narrows the working range to its last `sample_sz` elements.
+        void sample( size_t sample_sz ) {
+            first_copy = last_copy - sample_sz;
+            first = last - sample_sz;
         }
 
         DataIt begin_data( void ) {
@@ -120,9 +168,12 @@ class DataScenarios {
         }
 
         void runScenery ( void ) {
+            tr::Span span( "runScenery", "data", last - first, name().c_str() );
             reset();
             auto scenery = (*m_curr_scenery).second;
-            sc::notDecreasing(first, last);
+            // Restore the window's own ascending keys in linear time; generators may have overwritten them.
+            // The window is the tail of a buffer filled with 1..max, so this writes max-n+1..max.
+            std::iota(first, last, static_cast<DataType>(first - &*data.begin()) + 1);
 
             scenery(first, last);
         }
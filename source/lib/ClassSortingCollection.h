@@ -7,8 +7,11 @@ using std::vector;
 using std::advance;
 #include <utility>
 using std::pair;
+#include <string>
+#include <type_traits>
 
 #include "sorting.h"
+#include "baselines.h"
 
 template <typename DataType, typename RandomIt, typename Compare>
 class SortingCollection {
@@ -19,6 +22,7 @@ class SortingCollection {
 
         vector<MapItem> m_sorting_algs;
         typename vector<MapItem>::iterator m_curr_algo;
+        size_t m_first_baseline; //!< Baselines are registered after every algorithm of ours.
 
     public:
         enum algorithm_t {
@@ -30,6 +34,12 @@ class SortingCollection {
             MERGE = 32,
             RADIX = 64,
             ALL_ALGORITHMS = 127,
+            STD_SORT = 128,
+            STD_STABLE_SORT = 256,
+            STD_SORT_PAR = 512,
+            STD_SORT_PAR_UNSEQ = 1024,
+            QSORT = 2048,
+            ALL_BASELINES = 3968,
         };
 
         SortingCollection(short selected_algs = 1){
@@ -52,8 +62,33 @@ class SortingCollection {
             if ( selected_algs & MERGE)
                 m_sorting_algs.push_back(std::make_pair<std::string, SortFuncType>("merge", sa::merge));
 
-            if ( selected_algs & RADIX)
-                m_sorting_algs.push_back(std::make_pair<std::string, SortFuncType>("radix", sa::radix));
+            // Radix relies on `/` and `%` over the keys, so it only exists for integral data.
+            if constexpr ( std::is_integral<DataType>::value ) {
+                if ( selected_algs & RADIX)
+                    m_sorting_algs.push_back(std::make_pair<std::string, SortFuncType>("radix", sa::radix));
+            }
+
+            m_first_baseline = m_sorting_algs.size();
+
+            if ( selected_algs & STD_SORT)
+                m_sorting_algs.push_back(std::make_pair<std::string, SortFuncType>("std_sort", sb::std_sort));
+
+            if ( selected_algs & STD_STABLE_SORT)
+                m_sorting_algs.push_back(std::make_pair<std::string, SortFuncType>("std_stable_sort", sb::std_stable_sort));
+
+#if SB_HAS_PARALLEL
+            if ( selected_algs & STD_SORT_PAR)
+                m_sorting_algs.push_back(std::make_pair<std::string, SortFuncType>("std_sort_par", sb::std_sort_par));
+
+            if ( selected_algs & STD_SORT_PAR_UNSEQ)
+                m_sorting_algs.push_back(std::make_pair<std::string, SortFuncType>("std_sort_par_unseq", sb::std_sort_par_unseq));
+#endif
+
+            // qsort moves elements with memcpy.
+            if constexpr ( std::is_trivially_copyable<DataType>::value ) {
+                if ( selected_algs & QSORT)
+                    m_sorting_algs.push_back(std::make_pair<std::string, SortFuncType>("qsort", sb::c_qsort));
+            }
 
             m_curr_algo = m_sorting_algs.begin();
         }
@@ -79,6 +114,11 @@ class SortingCollection {
         std::string name(void) const {
             return (*m_curr_algo).first;
         }
+
+        /// True if the current algorithm is a toolchain reference rather than one of ours.
+        bool is_baseline(void) const {
+            return static_cast<size_t>( m_curr_algo - m_sorting_algs.begin() ) >= m_first_baseline;
+        }
 };
 
 
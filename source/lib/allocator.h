@@ -0,0 +1,257 @@
+/**
+ * Allocation policies for benchmark buffers: transparent or explicit huge
+ * pages, binding to the NUMA node of the running thread and pre-faulting,
+ * so the TLB and NUMA effects on each algorithm can be measured.
+ * @file allocator.h
+ */
+
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "memtrack.h"
+#include "scratch.h"
+
+namespace ba { // ba = benchmark allocation
+    enum policy_t {
+        DEFAULT = 0,           //!< Plain `operator new`.
+        TRANSPARENT_HUGE = 1,  //!< 2 MiB aligned mapping with `madvise(MADV_HUGEPAGE)`.
+        EXPLICIT_HUGE = 2,     //!< `MAP_HUGETLB` from the reserved pool; falls back to transparent.
+        NUMA_LOCAL = 4,        //!< `mbind` to the node of the calling thread, which is kept on that node's CPUs.
+        PREFAULT = 8,          //!< Touch every page on allocation, before the buffer is first written (not for sort scratch).
+    };
+
+    /// Huge page size, and the smallest request that goes through the policy.
+    constexpr size_t HUGE_PAGE = size_t{1} << 21;
+    constexpr size_t SMALL_PAGE = 4096;
+
+    /// Policy picked up by allocators constructed from now on.
+    inline short global_policy = DEFAULT;
+
+#ifdef __linux__
+    /*!
+     * Fills `set` with the CPUs of NUMA node `node`, parsed from its sysfs
+     * cpulist (e.g. "0-7,16-23").
+     *
+     * @return false if the node has no readable cpulist.
+     */
+    inline bool node_cpus( unsigned node, cpu_set_t &set )
+    {
+        std::ifstream in( "/sys/devices/system/node/node" + std::to_string( node ) + "/cpulist" );
+        std::string list;
+        if ( not std::getline( in, list ) )
+            return false;
+
+        CPU_ZERO( &set );
+        std::stringstream ranges( list );
+        std::string range;
+        while ( std::getline( ranges, range, ',' ) )
+        {
+            if ( range.empty() )
+                continue;
+            size_t dash = range.find( '-' );
+            int lo = std::stoi( range.substr( 0, dash ) );
+            int hi = dash == std::string::npos ? lo : std::stoi( range.substr( dash+1 ) );
+            for ( int cpu = lo; cpu <= hi and cpu < CPU_SETSIZE; cpu++ )
+                CPU_SET( cpu, &set );
+        }
+        return CPU_COUNT( &set ) > 0;
+    }
+
+    /// Length of the mapping actually used for `bytes` under `policy`.
+    inline size_t mapping_length( size_t bytes, short policy )
+    {
+        size_t page = ( policy & (TRANSPARENT_HUGE | EXPLICIT_HUGE) ) ? HUGE_PAGE : SMALL_PAGE;
+        return ( bytes + page - 1 ) / page * page;
+    }
+
+    /// Binds [addr, addr+len) to the NUMA node of the calling thread; a no-op on single-node hosts.
+    inline void bind_local( void *addr, size_t len )
+    {
+        constexpr int MPOL_BIND_MODE = 2;
+        unsigned cpu = 0, node = 0;
+        if ( syscall( SYS_getcpu, &cpu, &node, nullptr ) != 0 or node >= 64 )
+            return;
+        unsigned long mask = 1UL << node;
+        syscall( SYS_mbind, addr, len, MPOL_BIND_MODE, &mask, 64, 0 );
+    }
+
+    /// Maps `len` bytes aligned to a huge page, trimming the excess of an oversized mapping.
+    inline void * map_aligned( size_t len )
+    {
+        size_t over = len + HUGE_PAGE;
+        void *raw = mmap( nullptr, over, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+        if ( raw == MAP_FAILED )
+            return nullptr;
+
+        uintptr_t start = reinterpret_cast<uintptr_t>( raw );
+        uintptr_t aligned = ( start + HUGE_PAGE - 1 ) & ~( HUGE_PAGE - 1 );
+        if ( aligned > start )
+            munmap( raw, aligned - start );
+        size_t tail = ( start + over ) - ( aligned + len );
+        if ( tail > 0 )
+            munmap( reinterpret_cast<void *>( aligned + len ), tail );
+        return reinterpret_cast<void *>( aligned );
+    }
+
+    /*!
+     * Allocates `bytes` according to `policy`. Requests below one huge page,
+     * and every request under `DEFAULT`, go to `operator new`.
+     */
+    inline void * allocate( size_t bytes, short policy )
+    {
+        if ( policy == DEFAULT or bytes < HUGE_PAGE )
+            return ::operator new( bytes );
+
+        size_t len = mapping_length( bytes, policy );
+        void *ptr = nullptr;
+
+        if ( policy & EXPLICIT_HUGE )
+        {
+            ptr = mmap( nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0 );
+            if ( ptr == MAP_FAILED )
+                ptr = nullptr;
+        }
+        if ( ptr == nullptr )
+        {
+            ptr = ( policy & (TRANSPARENT_HUGE | EXPLICIT_HUGE) ) ? map_aligned( len )
+                : mmap( nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+            if ( ptr == MAP_FAILED or ptr == nullptr )
+                throw std::bad_alloc();
+            if ( policy & (TRANSPARENT_HUGE | EXPLICIT_HUGE) )
+                madvise( ptr, len, MADV_HUGEPAGE );
+        }
+
+        if ( policy & NUMA_LOCAL )
+            bind_local( ptr, len );
+
+        if ( policy & PREFAULT )
+        {
+            volatile char *page = static_cast<char *>( ptr );
+            for ( size_t offset = 0; offset < len; offset += SMALL_PAGE )
+                page[offset] = 0;
+        }
+
+        // Count what was asked for, so the memory columns compare across policies.
+        // Scenario buffers live outside any MemScope and scratch inside one, so alloc and free see the same state.
+        if ( mt::is_counting() )
+            mt::note_alloc( bytes );
+        return ptr;
+    }
+
+    /// Releases memory obtained from `allocate` with the same `bytes` and `policy`.
+    inline void deallocate( void *ptr, size_t bytes, short policy )
+    {
+        if ( policy == DEFAULT or bytes < HUGE_PAGE )
+        {
+            ::operator delete( ptr );
+            return;
+        }
+        size_t len = mapping_length( bytes, policy );
+        munmap( ptr, len );
+        if ( mt::is_counting() )
+            mt::note_free( bytes );
+    }
+
+    /*!
+     * Routes the algorithms' scratch buffers (sa::scratch_vector) through the
+     * global policy, minus `PREFAULT`: they are allocated inside the timed sort
+     * and written right away, so touching them beforehand would only add time.
+     */
+    inline void install_scratch_hooks( void )
+    {
+        sa::scratch_allocate = []( size_t bytes ){ return allocate( bytes, global_policy & ~PREFAULT ); };
+        sa::scratch_deallocate = []( void *ptr, size_t bytes ){ deallocate( ptr, bytes, global_policy & ~PREFAULT ); };
+    }
+
+    /*!
+     * Sets the policy for subsequently created buffers. With `NUMA_LOCAL` the
+     * calling thread is restricted to the CPUs of the node it is running on, so
+     * its memory and its accesses stay on one node while threads it spawns
+     * (e.g. the workers of the parallel baselines) still get every core there.
+     * The sorting algorithms' scratch buffers follow the policy too.
+     */
+    inline void set_policy( short policy )
+    {
+        global_policy = policy;
+        install_scratch_hooks();
+        if ( policy & NUMA_LOCAL )
+        {
+            unsigned cpu = 0, node = 0;
+            cpu_set_t set;
+            if ( syscall( SYS_getcpu, &cpu, &node, nullptr ) == 0 and node_cpus( node, set ) )
+                sched_setaffinity( 0, sizeof(set), &set );
+        }
+    }
+
+#else
+    inline void set_policy( short policy ) { global_policy = policy; }
+    inline void * allocate( size_t bytes, short ) { return ::operator new( bytes ); }
+    inline void deallocate( void *ptr, size_t, short ) { ::operator delete( ptr ); }
+#endif
+
+    /*!
+     * Standard allocator that routes large buffers through the policy that was
+     * global when it was constructed. The policy travels with the allocator, so
+     * a buffer is always released the same way it was obtained. Elements are
+     * default-initialized, so with `PREFAULT` the pre-faulting pass, not a
+     * zero fill, is what first touches the pages.
+     */
+    template < typename T >
+    class BenchAllocator {
+        public:
+            using value_type = T;
+
+            short m_policy;
+
+            BenchAllocator() noexcept : m_policy( global_policy ) {}
+
+            explicit BenchAllocator( short policy ) noexcept : m_policy( policy ) {}
+
+            template < typename U >
+            BenchAllocator( const BenchAllocator<U> &other ) noexcept : m_policy( other.m_policy ) {}
+
+            T * allocate( size_t n ) {
+                return static_cast<T *>( ba::allocate( n * sizeof(T), m_policy ) );
+            }
+
+            void deallocate( T *ptr, size_t n ) noexcept {
+                ba::deallocate( ptr, n * sizeof(T), m_policy );
+            }
+
+            template < typename U, typename... Args >
+            void construct( U *ptr, Args&&... args ) {
+                if constexpr ( sizeof...(Args) == 0 )
+                    ::new( static_cast<void *>( ptr ) ) U;
+                else
+                    ::new( static_cast<void *>( ptr ) ) U( std::forward<Args>( args )... );
+            }
+
+            template < typename U >
+            bool operator==( const BenchAllocator<U> &other ) const noexcept { return m_policy == other.m_policy; }
+
+            template < typename U >
+            bool operator!=( const BenchAllocator<U> &other ) const noexcept { return m_policy != other.m_policy; }
+    };
+
+    /// Vector whose storage follows the benchmark allocation policy.
+    template < typename T >
+    using vector = std::vector<T, BenchAllocator<T>>;
+}
+
+#endif // ALLOCATOR_H
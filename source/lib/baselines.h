@@ -0,0 +1,85 @@
+/**
+ * Reference sorts shipped with the toolchain, wrapped with the same signature
+ * as the algorithms in sorting.h so they run through the same timing path.
+ * @file baselines.h
+ */
+
+#ifndef BASELINES_H
+#define BASELINES_H
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+
+#if __has_include(<execution>)
+#include <execution>
+#endif
+
+#if defined(__cpp_lib_execution) || defined(__cpp_lib_parallel_algorithm)
+#define SB_HAS_PARALLEL 1
+#else
+#define SB_HAS_PARALLEL 0
+#endif
+
+namespace sb { // sb = sorting baselines
+    /// `std::sort` (introsort).
+    template< typename RandomIt, typename Compare >
+    void std_sort(RandomIt first, RandomIt last, Compare cmp)
+    {
+        std::sort( first, last, cmp );
+    }
+
+    /// `std::stable_sort` (merge sort with a temporary buffer).
+    template< typename RandomIt, typename Compare >
+    void std_stable_sort(RandomIt first, RandomIt last, Compare cmp)
+    {
+        std::stable_sort( first, last, cmp );
+    }
+
+#if SB_HAS_PARALLEL
+    /// `std::sort` with `std::execution::par`, on whatever backend the standard library was built with.
+    template< typename RandomIt, typename Compare >
+    void std_sort_par(RandomIt first, RandomIt last, Compare cmp)
+    {
+        std::sort( std::execution::par, first, last, cmp );
+    }
+
+    /// `std::sort` with `std::execution::par_unseq`.
+    template< typename RandomIt, typename Compare >
+    void std_sort_par_unseq(RandomIt first, RandomIt last, Compare cmp)
+    {
+        std::sort( std::execution::par_unseq, first, last, cmp );
+    }
+#endif
+
+    /// Adapts a **less** comparison to the three-way callback `qsort` expects.
+    template< typename DataType, typename Compare >
+    struct QsortAdapter {
+        static inline thread_local Compare cmp;
+
+        static int call( const void *a, const void *b ) {
+            const DataType &x = *static_cast<const DataType *>( a );
+            const DataType &y = *static_cast<const DataType *>( b );
+            if ( cmp( x, y ) ) return -1;
+            if ( cmp( y, x ) ) return 1;
+            return 0;
+        }
+    };
+
+    /**
+     * C `qsort` over a contiguous range. The comparison is forwarded through a
+     * thread-local slot because `qsort` accepts a plain function pointer only.
+     */
+    template< typename RandomIt, typename Compare >
+    void c_qsort(RandomIt first, RandomIt last, Compare cmp)
+    {
+        using myType = typename std::iterator_traits<RandomIt>::value_type;
+
+        if ( first == last )
+            return;
+        QsortAdapter<myType, Compare>::cmp = cmp;
+        std::qsort( &*first, std::distance( first, last ), sizeof(myType), QsortAdapter<myType, Compare>::call );
+    }
+}
+
+#endif // BASELINES_H
@@ -0,0 +1,384 @@
+/**
+ * External-memory sorting of binary files larger than the memory budget:
+ * sorted runs are produced with any in-memory algorithm and then combined
+ * by a k-way loser-tree merge fed by a read-ahead I/O thread.
+ * @file external_sort.h
+ */
+
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace es { // es = external sorting
+    //{{{ I/O WORKER
+    /*!
+     * A single background thread that runs I/O jobs in submission order.
+     * Reads and writes are handed to it so the merge keeps running while the
+     * disk is busy; exceptions thrown by a job reach the caller through its future.
+     */
+    class IoWorker {
+        private:
+            std::mutex m_mutex;
+            std::condition_variable m_cv;
+            std::deque<std::packaged_task<void()>> m_jobs;
+            bool m_stop{false};
+            std::thread m_thread; //!< Declared last: it starts running once constructed.
+
+            void loop( void ) {
+                for (;;) {
+                    std::packaged_task<void()> job;
+                    {
+                        std::unique_lock<std::mutex> lock( m_mutex );
+                        m_cv.wait( lock, [this]{ return m_stop or not m_jobs.empty(); } );
+                        if ( m_jobs.empty() )
+                            return;
+                        job = std::move( m_jobs.front() );
+                        m_jobs.pop_front();
+                    }
+                    job();
+                }
+            }
+
+        public:
+            IoWorker() : m_thread( &IoWorker::loop, this ) {}
+
+            ~IoWorker() {
+                {
+                    std::lock_guard<std::mutex> lock( m_mutex );
+                    m_stop = true;
+                }
+                m_cv.notify_one();
+                m_thread.join();
+            }
+
+            IoWorker( const IoWorker& ) = delete;
+            IoWorker& operator=( const IoWorker& ) = delete;
+
+            std::future<void> submit( std::function<void()> job ) {
+                std::packaged_task<void()> task( std::move( job ) );
+                std::future<void> done = task.get_future();
+                {
+                    std::lock_guard<std::mutex> lock( m_mutex );
+                    m_jobs.push_back( std::move( task ) );
+                }
+                m_cv.notify_one();
+                return done;
+            }
+    };
+    //}}} I/O WORKER
+
+    /// Owning handle for a C stream.
+    using File = std::unique_ptr<std::FILE, int (*)(std::FILE *)>;
+
+    inline File open_file( const std::string &path, const char *mode )
+    {
+        File file( std::fopen( path.c_str(), mode ), std::fclose );
+        if ( not file )
+            throw std::runtime_error( "external sort: cannot open " + path );
+        return file;
+    }
+
+    //{{{ RUN READER
+    /*!
+     * Sequential reader over a run file with double buffering: while the merge
+     * consumes the front buffer, the worker is already filling the back one.
+     */
+    template < typename DataType >
+    class RunReader {
+        private:
+            File m_file;
+            IoWorker *m_io;
+            std::vector<DataType> m_front, m_back;
+            size_t m_pos{0}, m_front_len{0}, m_back_len{0};
+            std::future<void> m_pending;
+
+            void prefetch( void ) {
+                m_pending = m_io->submit( [this]{
+                    m_back_len = std::fread( m_back.data(), sizeof(DataType), m_back.size(), m_file.get() );
+                    if ( std::ferror( m_file.get() ) )
+                        throw std::runtime_error( "external sort: read error" );
+                } );
+            }
+
+        public:
+            RunReader( const std::string &path, size_t buffer_elems, IoWorker &io )
+                : m_file( open_file( path, "rb" ) ), m_io( &io ),
+                  m_front( buffer_elems ), m_back( buffer_elems ) {
+                prefetch();
+                refill();
+            }
+
+            ~RunReader() {
+                if ( m_pending.valid() )
+                    m_pending.wait();
+            }
+
+            bool empty( void ) const { return m_pos == m_front_len; }
+
+            const DataType & head( void ) const { return m_front[m_pos]; }
+
+            void pop( void ) {
+                if ( ++m_pos == m_front_len )
+                    refill();
+            }
+
+        private:
+            void refill( void ) {
+                m_pending.get();
+                std::swap( m_front, m_back );
+                m_front_len = m_back_len;
+                m_pos = 0;
+                if ( m_front_len > 0 )
+                    prefetch();
+            }
+    };
+    //}}} RUN READER
+
+    //{{{ RUN WRITER
+    /// Sequential writer with double buffering; full buffers are flushed by the worker.
+    template < typename DataType >
+    class RunWriter {
+        private:
+            File m_file;
+            IoWorker *m_io;
+            std::vector<DataType> m_front, m_back;
+            size_t m_len{0};
+            std::future<void> m_pending;
+
+        public:
+            RunWriter( const std::string &path, size_t buffer_elems, IoWorker &io )
+                : m_file( open_file( path, "wb" ) ), m_io( &io ),
+                  m_front( buffer_elems ), m_back( buffer_elems ) {}
+
+            ~RunWriter() {
+                if ( m_pending.valid() )
+                    m_pending.wait();
+            }
+
+            void push( const DataType &value ) {
+                m_front[m_len++] = value;
+                if ( m_len == m_front.size() )
+                    flush_async();
+            }
+
+            /// Writes whatever is buffered and waits for the disk.
+            void close( void ) {
+                flush_async();
+                m_pending.get();
+                if ( std::fflush( m_file.get() ) != 0 )
+                    throw std::runtime_error( "external sort: write error" );
+            }
+
+        private:
+            void flush_async( void ) {
+                if ( m_pending.valid() )
+                    m_pending.get();
+                std::swap( m_front, m_back );
+                size_t len = m_len;
+                m_len = 0;
+                m_pending = m_io->submit( [this, len]{
+                    if ( std::fwrite( m_back.data(), sizeof(DataType), len, m_file.get() ) != len )
+                        throw std::runtime_error( "external sort: write error" );
+                } );
+            }
+    };
+    //}}} RUN WRITER
+
+    //{{{ LOSER TREE
+    /*!
+     * Tournament tree over k run readers. Internal node `n` stores the loser of
+     * the match played there, so replacing the winner costs one comparison per
+     * level on the path from its leaf to the root. Exhausted runs lose every match.
+     */
+    template < typename DataType, typename Compare >
+    class LoserTree {
+        private:
+            std::vector<std::unique_ptr<RunReader<DataType>>> *m_runs;
+            Compare m_cmp;
+            std::vector<int> m_losers;
+            int m_winner{0};
+            int m_k;
+
+            /// True if run `a` must be output before run `b`.
+            bool beats( int a, int b ) const {
+                const auto &ra = *(*m_runs)[a], &rb = *(*m_runs)[b];
+                if ( ra.empty() ) return false;
+                if ( rb.empty() ) return true;
+                if ( m_cmp( ra.head(), rb.head() ) ) return true;
+                if ( m_cmp( rb.head(), ra.head() ) ) return false;
+                return a < b;
+            }
+
+        public:
+            LoserTree( std::vector<std::unique_ptr<RunReader<DataType>>> &runs, Compare cmp )
+                : m_runs( &runs ), m_cmp( cmp ), m_losers( runs.size() ), m_k( runs.size() ) {
+                std::vector<int> winners( 2*m_k );
+                for ( int i = 0; i < m_k; i++ )
+                    winners[m_k+i] = i;
+                for ( int node = m_k-1; node > 0; node-- )
+                {
+                    int l = winners[2*node], r = winners[2*node+1];
+                    winners[node] = beats( r, l ) ? r : l;
+                    m_losers[node] = beats( r, l ) ? l : r;
+                }
+                m_winner = m_k > 1 ? winners[1] : 0;
+            }
+
+            bool empty( void ) const { return (*m_runs)[m_winner]->empty(); }
+
+            const DataType & top( void ) const { return (*m_runs)[m_winner]->head(); }
+
+            /// Consumes the smallest element and replays its path.
+            void pop( void ) {
+                (*m_runs)[m_winner]->pop();
+                int current = m_winner;
+                for ( int node = (current + m_k)/2; node > 0; node /= 2 )
+                {
+                    if ( beats( m_losers[node], current ) )
+                        std::swap( m_losers[node], current );
+                }
+                m_winner = current;
+            }
+    };
+    //}}} LOSER TREE
+
+    /// Where the time of an external sort went.
+    struct ExternalStats {
+        size_t bytes{0};          //!< Size of the input.
+        size_t runs{0};           //!< Initial sorted runs.
+        size_t merge_passes{0};   //!< Merge passes over the data.
+        double run_seconds{0};    //!< Run formation (read, sort, write).
+        double merge_seconds{0};  //!< All merge passes.
+
+        double throughput_mbs( void ) const {
+            double total = run_seconds + merge_seconds;
+            return total > 0 ? bytes / (1024.0*1024.0) / total : 0.0;
+        }
+    };
+
+    //{{{ EXTERNAL SORT
+    /*!
+     * Sorts the binary file `input` of `DataType` values into `output`.
+     *
+     * Run formation reads chunks of `memory_limit` bytes with plain streaming
+     * reads, sorts each chunk in memory with `sorting` and writes it as a run.
+     * Runs are then merged with a loser tree; each run gets two I/O buffers
+     * carved from the same budget, and when that would make buffers smaller
+     * than `min_buffer` bytes the merge is done in several passes.
+     *
+     * @note The limit covers the data held by this function. Algorithms with
+     * auxiliary storage (e.g. merge and radix) allocate on top of it.
+     *
+     * @param input Path of the file to sort.
+     * @param output Path of the sorted file.
+     * @param tmp_dir Directory for the temporary run files.
+     * @param memory_limit Memory budget in bytes.
+     * @param sorting In-memory algorithm used for the runs.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     * @param min_buffer Smallest acceptable I/O buffer per run, in bytes.
+     * @return Timing and size figures for the whole pipeline.
+     */
+    template < typename DataType, typename SortFunc, typename Compare >
+    ExternalStats sort( const std::string &input, const std::string &output, const std::string &tmp_dir,
+                        size_t memory_limit, SortFunc sorting, Compare cmp,
+                        size_t min_buffer = 1 << 20 )
+    {
+        using clock = std::chrono::steady_clock;
+        ExternalStats stats;
+        IoWorker io;
+
+        size_t chunk_elems = std::max<size_t>( memory_limit / sizeof(DataType), 1 );
+        std::vector<std::string> runs;
+
+        //=== Run formation ===
+        auto start = clock::now();
+        {
+            File in = open_file( input, "rb" );
+            std::vector<DataType> chunk( chunk_elems );
+            for (;;)
+            {
+                size_t len = std::fread( chunk.data(), sizeof(DataType), chunk_elems, in.get() );
+                if ( len == 0 )
+                    break;
+                stats.bytes += len * sizeof(DataType);
+
+                sorting( chunk.begin(), chunk.begin() + len, cmp );
+
+                runs.push_back( tmp_dir + "/run_0_" + std::to_string( runs.size() ) + ".bin" );
+                File out = open_file( runs.back(), "wb" );
+                if ( std::fwrite( chunk.data(), sizeof(DataType), len, out.get() ) != len )
+                    throw std::runtime_error( "external sort: write error" );
+            }
+        }
+        stats.runs = runs.size();
+        stats.run_seconds = std::chrono::duration<double>( clock::now() - start ).count();
+
+        //=== Merge passes ===
+        start = clock::now();
+        size_t min_elems = std::max<size_t>( min_buffer / sizeof(DataType), 1 );
+        size_t total_elems = std::max<size_t>( memory_limit / sizeof(DataType), 4 );
+        size_t slots = total_elems / (2*min_elems);
+        size_t fan_in = slots > 3 ? slots-1 : 2;
+
+        if ( runs.empty() )
+            open_file( output, "wb" );
+
+        for ( size_t pass = 1; not runs.empty(); pass++ )
+        {
+            bool last_pass = runs.size() <= fan_in;
+            std::vector<std::string> next_runs;
+
+            for ( size_t group = 0; group < runs.size(); group += fan_in )
+            {
+                size_t k = std::min( fan_in, runs.size() - group );
+                // Two buffers per input run plus two for the output.
+                size_t buffer_elems = std::max<size_t>( total_elems / (2*(k+1)), 1 );
+
+                std::string target = last_pass ? output
+                    : tmp_dir + "/run_" + std::to_string( pass ) + "_" + std::to_string( next_runs.size() ) + ".bin";
+
+                std::vector<std::unique_ptr<RunReader<DataType>>> readers;
+                for ( size_t r = 0; r < k; r++ )
+                    readers.push_back( std::make_unique<RunReader<DataType>>( runs[group+r], buffer_elems, io ) );
+
+                RunWriter<DataType> writer( target, buffer_elems, io );
+                LoserTree<DataType, Compare> tree( readers, cmp );
+                while ( not tree.empty() )
+                {
+                    writer.push( tree.top() );
+                    tree.pop();
+                }
+                writer.close();
+
+                readers.clear();
+                for ( size_t r = 0; r < k; r++ )
+                    std::remove( runs[group+r].c_str() );
+                next_runs.push_back( target );
+            }
+
+            stats.merge_passes++;
+            if ( last_pass )
+                break;
+            runs = next_runs;
+        }
+        stats.merge_seconds = std::chrono::duration<double>( clock::now() - start ).count();
+
+        return stats;
+    }
+    //}}} EXTERNAL SORT
+}
+
+#endif // EXTERNAL_SORT_H
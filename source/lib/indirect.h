@@ -0,0 +1,192 @@
+/**
+ * Indirect (key + index) sorting for ranges of large records.
+ * @file indirect.h
+ */
+
+#ifndef INDIRECT_H
+#define INDIRECT_H
+
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "sorting.h"
+
+namespace sa { // sa = sorting algorithms
+    /// Key and original position packed into a single word: `(key - min_key) << index_bits | index`.
+    using packed_t = std::uint64_t;
+    using PackedIt = std::vector<packed_t>::iterator;
+    using PackedCompare = bool (*)(const packed_t&, const packed_t&);
+    using PackedSortFunc = void (*)(PackedIt, PackedIt, PackedCompare);
+
+    /// Default order for packed pairs: by key, ties broken by original position.
+    constexpr bool packed_less( const packed_t &a, const packed_t &b ){
+        return ( a < b );
+    }
+
+    /// Number of bits needed to represent `value`.
+    inline unsigned bit_width( std::uint64_t value )
+    {
+        unsigned bits = 0;
+        while ( value > 0 )
+        {
+            value >>= 1;
+            bits++;
+        }
+        return bits;
+    }
+
+    /*!
+     * Order of an index array by the projected keys it refers to, ties broken by
+     * index. The keys live in a thread-local pointer because the sorting
+     * collections only take plain function pointers as comparators.
+     */
+    template < typename Key >
+    struct IndexOrder {
+        static inline thread_local const Key *keys = nullptr;
+
+        static bool less( const packed_t &a, const packed_t &b ){
+            if ( keys[a] < keys[b] ) return true;
+            if ( keys[b] < keys[a] ) return false;
+            return ( a < b );
+        }
+    };
+
+    //{{{ APPLY PERMUTATION
+    /*!
+     * Reorders [first, last) in place so that the element at position `i` becomes
+     * the one that was at position `perm[i]`, following each cycle of the permutation.
+     * Every record is moved exactly once plus one temporary per cycle.
+     *
+     * @note `perm` is used as scratch space: on return it holds the identity permutation.
+     *
+     * @param first Pointer/iterator to the beginning of the range we wish to reorder.
+     * @param last Pointer/iterator to the location just past the last valid value of the range.
+     * @param perm Pointer/iterator to the first index of the permutation (same length as the range).
+     * @tparam RandomIt A random access iterator to the records.
+     * @tparam IndexIt A random access iterator to the indices.
+     */
+    template < typename RandomIt, typename IndexIt >
+    void apply_permutation( RandomIt first, RandomIt last, IndexIt perm )
+    {
+        using myType = typename std::iterator_traits<RandomIt>::value_type;
+        using index_t = typename std::iterator_traits<IndexIt>::value_type;
+
+        index_t length = static_cast<index_t>( std::distance( first, last ) );
+
+        for ( index_t i = 0; i < length; i++ )
+        {
+            if ( perm[i] == i )
+                continue;
+
+            myType temporary = std::move( first[i] );
+            index_t curr = i;
+            while ( perm[curr] != i )
+            {
+                index_t src = perm[curr];
+                first[curr] = std::move( first[src] );
+                perm[curr] = curr;
+                curr = src;
+            }
+            first[curr] = std::move( temporary );
+            perm[curr] = curr;
+        }
+    }
+    //}}} APPLY PERMUTATION
+
+    //{{{ INDIRECT SORT
+    /*!
+     * Sorts [first, last) by the key returned from `key(record)` without moving the
+     * records during the sort itself. Each record contributes one packed key + index
+     * word, the packed array is sorted with `sorting` (any algorithm in a
+     * `SortingCollection<packed_t, PackedIt, PackedCompare>`), and the records are
+     * then moved into place once by `apply_permutation`.
+     *
+     * When the key is not integral, or its range and the index do not fit together
+     * in 64 bits, the keys are copied out and a plain index array is sorted instead,
+     * comparing the keys it points to (`IndexOrder`). `cmp` does not apply to that
+     * path, and radix, which orders words by value, is replaced there by merge.
+     *
+     * Since the original position always breaks ties the result is stable,
+     * regardless of the algorithm chosen.
+     *
+     * @param first Pointer/iterator to the beginning of the range we wish to sort.
+     * @param last Pointer/iterator to the location just past the last valid value of the range.
+     * @param key Projection that extracts the key from a record; the only field comparisons read.
+     * @param sorting Sorting algorithm applied to the packed (or index) array.
+     * @param cmp Comparison applied to the packed array.
+     * @tparam RandomIt A random access iterator to the records.
+     * @tparam Projection A callable `record -> key`, where keys are ordered by `operator<`.
+     */
+    template < typename RandomIt, typename Projection >
+    void indirect( RandomIt first, RandomIt last, Projection key,
+                   PackedSortFunc sorting, PackedCompare cmp = packed_less )
+    {
+        using key_t = typename std::decay<decltype( key( *first ) )>::type;
+
+        size_t length = std::distance( first, last );
+        if ( length < 2 )
+            return;
+
+        unsigned index_bits = bit_width( length-1 );
+        std::vector<packed_t> packed( length );
+
+        if constexpr ( std::is_integral<key_t>::value )
+        {
+            using ukey_t = typename std::make_unsigned<key_t>::type;
+
+            key_t smallest = key( *first ), largest = smallest;
+            for ( RandomIt it = first+1; it < last; it++ )
+            {
+                key_t k = key( *it );
+                if ( k < smallest ) smallest = k;
+                if ( largest < k ) largest = k;
+            }
+
+            unsigned key_bits = bit_width( static_cast<ukey_t>( static_cast<ukey_t>( largest ) - static_cast<ukey_t>( smallest ) ) );
+            if ( index_bits + key_bits <= std::numeric_limits<packed_t>::digits )
+            {
+                for ( size_t i = 0; i < length; i++ )
+                {
+                    packed_t offset = static_cast<ukey_t>( static_cast<ukey_t>( key( first[i] ) ) - static_cast<ukey_t>( smallest ) );
+                    packed[i] = ( offset << index_bits ) | i;
+                }
+
+                sorting( packed.begin(), packed.end(), cmp );
+
+                // Reuse the packed buffer as the permutation: keep only the index bits.
+                packed_t mask = ( index_bits == 0 ) ? 0 : ( ~packed_t{0} >> ( std::numeric_limits<packed_t>::digits - index_bits ) );
+                for ( auto &p : packed )
+                    p &= mask;
+
+                apply_permutation( first, last, packed.begin() );
+                return;
+            }
+        }
+
+        // Index fallback: sort positions by the keys they refer to.
+        std::vector<key_t> keys;
+        keys.reserve( length );
+        for ( RandomIt it = first; it < last; it++ )
+            keys.push_back( key( *it ) );
+        for ( size_t i = 0; i < length; i++ )
+            packed[i] = i;
+
+        PackedSortFunc index_sort = sorting;
+        if ( sorting == static_cast<PackedSortFunc>( sa::radix<PackedIt, PackedCompare> ) )
+            index_sort = sa::merge<PackedIt, PackedCompare>;
+
+        const key_t *saved = IndexOrder<key_t>::keys;
+        IndexOrder<key_t>::keys = keys.data();
+        index_sort( packed.begin(), packed.end(), IndexOrder<key_t>::less );
+        IndexOrder<key_t>::keys = saved;
+
+        apply_permutation( first, last, packed.begin() );
+    }
+    //}}} INDIRECT SORT
+}
+
+#endif // INDIRECT_H
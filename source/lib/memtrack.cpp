@@ -0,0 +1,100 @@
+/**
+ * Counting replacements of the global allocation functions.
+ * Each block carries a small header with its size so that `operator delete`
+ * can keep the live-byte counter exact without relying on sized deallocation.
+ * Blocks obtained while counting is off carry `UNCOUNTED` instead, so freeing
+ * them inside a `MemScope` does not subtract bytes that were never added.
+ * @file memtrack.cpp
+ */
+
+#include <cstdlib>
+#include <new>
+
+#include "memtrack.h"
+
+namespace mt {
+    /// Header size; keeps the user pointer aligned for any fundamental type.
+    constexpr size_t HEADER = alignof(std::max_align_t);
+
+    /// Header value of a block allocated while counting was off.
+    constexpr size_t UNCOUNTED = ~size_t{0};
+
+    static void * tracked_alloc( size_t size ) noexcept
+    {
+        void *block = std::malloc( size + HEADER );
+        if ( block == nullptr )
+            return nullptr;
+        if ( is_counting() )
+        {
+            *static_cast<size_t *>( block ) = size;
+            note_alloc( size );
+        }
+        else
+            *static_cast<size_t *>( block ) = UNCOUNTED;
+        return static_cast<char *>( block ) + HEADER;
+    }
+
+    static void tracked_free( void *ptr ) noexcept
+    {
+        if ( ptr == nullptr )
+            return;
+        void *block = static_cast<char *>( ptr ) - HEADER;
+        size_t size = *static_cast<size_t *>( block );
+        if ( size != UNCOUNTED )
+            note_free( size );
+        std::free( block );
+    }
+}
+
+void * operator new( size_t size )
+{
+    void *ptr = mt::tracked_alloc( size );
+    if ( ptr == nullptr )
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void * operator new[]( size_t size )
+{
+    return ::operator new( size );
+}
+
+void * operator new( size_t size, const std::nothrow_t & ) noexcept
+{
+    return mt::tracked_alloc( size );
+}
+
+void * operator new[]( size_t size, const std::nothrow_t & ) noexcept
+{
+    return mt::tracked_alloc( size );
+}
+
+void operator delete( void *ptr ) noexcept
+{
+    mt::tracked_free( ptr );
+}
+
+void operator delete[]( void *ptr ) noexcept
+{
+    mt::tracked_free( ptr );
+}
+
+void operator delete( void *ptr, size_t ) noexcept
+{
+    mt::tracked_free( ptr );
+}
+
+void operator delete[]( void *ptr, size_t ) noexcept
+{
+    mt::tracked_free( ptr );
+}
+
+void operator delete( void *ptr, const std::nothrow_t & ) noexcept
+{
+    mt::tracked_free( ptr );
+}
+
+void operator delete[]( void *ptr, const std::nothrow_t & ) noexcept
+{
+    mt::tracked_free( ptr );
+}
@@ -0,0 +1,126 @@
+/**
+ * Allocation and resident-memory tracking around a measured region.
+ * The counters are fed by the global `operator new`/`operator delete`
+ * replacements in memtrack.cpp, which must be linked into the program for
+ * heap allocations to be counted.
+ * @file memtrack.h
+ */
+
+#ifndef MEMTRACK_H
+#define MEMTRACK_H
+
+#include <atomic>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <sys/resource.h>
+
+namespace mt { // mt = memory tracking
+    /// Counting is only on inside a `MemScope`, so timed code pays a single branch per allocation.
+    inline std::atomic<bool> counting{false};
+
+    /// Process-wide counters, updated by every global allocation made while `counting`.
+    inline std::atomic<size_t> n_allocs{0};      //!< Number of allocations so far.
+    inline std::atomic<size_t> bytes_allocd{0};  //!< Bytes requested so far.
+    inline std::atomic<size_t> live_bytes{0};    //!< Bytes currently allocated.
+    inline std::atomic<size_t> peak_bytes{0};    //!< High-water mark of `live_bytes` since the last `reset_peak()`.
+
+    /// True while allocations are being counted.
+    inline bool is_counting( void )
+    {
+        return counting.load( std::memory_order_relaxed );
+    }
+
+    /*!
+     * Records an allocation of `size` bytes (also used by allocators that bypass
+     * `operator new`). Call only while `is_counting()`, and pair it with `note_free`.
+     */
+    inline void note_alloc( size_t size )
+    {
+        n_allocs.fetch_add( 1, std::memory_order_relaxed );
+        bytes_allocd.fetch_add( size, std::memory_order_relaxed );
+        size_t live = live_bytes.fetch_add( size, std::memory_order_relaxed ) + size;
+        size_t peak = peak_bytes.load( std::memory_order_relaxed );
+        while ( live > peak and not peak_bytes.compare_exchange_weak( peak, live, std::memory_order_relaxed ) )
+            ;
+    }
+
+    /// Records the release of `size` bytes.
+    inline void note_free( size_t size )
+    {
+        live_bytes.fetch_sub( size, std::memory_order_relaxed );
+    }
+
+    /// Restarts the high-water mark from the bytes currently live.
+    inline void reset_peak( void )
+    {
+        peak_bytes.store( live_bytes.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+    }
+
+    /*!
+     * Current resident set size in KiB, read from `/proc/self/status`.
+     * Falls back to the peak RSS reported by `getrusage` where procfs is missing.
+     */
+    inline long rss_kb( void )
+    {
+        std::ifstream status( "/proc/self/status" );
+        std::string field;
+        while ( status >> field )
+        {
+            if ( field == "VmRSS:" )
+            {
+                long kb;
+                status >> kb;
+                return kb;
+            }
+            status.ignore( 256, '\n' );
+        }
+
+        struct rusage usage;
+        getrusage( RUSAGE_SELF, &usage );
+        return usage.ru_maxrss;
+    }
+
+    /// What a measured region did to the heap.
+    struct MemStats {
+        size_t allocs{0};       //!< Allocations performed inside the region.
+        size_t bytes{0};        //!< Bytes requested inside the region.
+        size_t peak_bytes{0};   //!< Peak bytes live at once, above what was live on entry.
+        long rss_delta_kb{0};   //!< Change of the resident set size across the region.
+    };
+
+    /*!
+     * Snapshot taken around a measured region: call `begin()` right before the
+     * region and `end()` right after it. Counting is switched on only between the
+     * two, so the region should not also be timed. The RSS is read outside the
+     * counter window so that reading procfs does not count as the region's allocations.
+     */
+    class MemScope {
+        private:
+            size_t m_allocs, m_bytes, m_live;
+            long m_rss;
+
+        public:
+            void begin( void ) {
+                m_rss = rss_kb();
+                m_allocs = n_allocs.load( std::memory_order_relaxed );
+                m_bytes = bytes_allocd.load( std::memory_order_relaxed );
+                m_live = live_bytes.load( std::memory_order_relaxed );
+                reset_peak();
+                counting.store( true, std::memory_order_relaxed );
+            }
+
+            MemStats end( void ) {
+                counting.store( false, std::memory_order_relaxed );
+                MemStats stats;
+                stats.allocs = n_allocs.load( std::memory_order_relaxed ) - m_allocs;
+                stats.bytes = bytes_allocd.load( std::memory_order_relaxed ) - m_bytes;
+                size_t peak = peak_bytes.load( std::memory_order_relaxed );
+                stats.peak_bytes = peak > m_live ? peak - m_live : 0;
+                stats.rss_delta_kb = rss_kb() - m_rss;
+                return stats;
+            }
+    };
+}
+
+#endif // MEMTRACK_H
@@ -8,9 +8,23 @@
 #include <array>        // std::array
 #include <random>       // std::default_random_engine
 #include <chrono>       // std::chrono::system_clock
+#include <cmath>        // std::log, std::exp
+#include <functional>   // std::greater
+#include <iterator>     // std::iterator_traits
+#include <limits>       // std::numeric_limits
+#include <numeric>      // std::iota
 
 
 namespace sc { // sc = sorting algorithms
+    /// Seed shared by every randomized scenario, so a run can be reproduced exactly.
+    inline unsigned long seed = std::chrono::system_clock::now().time_since_epoch().count();
+
+    /// A fresh engine seeded with `seed`: the same sample size always gets the same data.
+    inline std::mt19937_64 engine( void )
+    {
+        return std::mt19937_64( seed );
+    }
+
     /*!
      * This function arranges the sample (array) for non-descending elements.
      * 
@@ -21,18 +35,9 @@ namespace sc { // sc = sorting algorithms
     template< typename FwrdIt >
     void notDecreasing( FwrdIt first, FwrdIt last )
     {
-        size_t length = std::distance( first, last );
-
-        for (size_t i = 0; i < length; i++)
-        {   
-            for (size_t j = 0; j < length-i-1; j++)
-            {
-                if (*(first+j) > *(first+j+1))
-                {
-                    std::swap(*(first+j), *(first+j+1));
-                }
-            }
-        }
+        // Samples usually arrive sorted already, which makes this a single linear check.
+        if ( not std::is_sorted( first, last ) )
+            std::sort( first, last );
     }
 
     /*!
@@ -45,18 +50,8 @@ namespace sc { // sc = sorting algorithms
     template< typename FwrdIt >
     void notGrowing( FwrdIt first, FwrdIt last )
     {
-        size_t length = std::distance( first, last );
-
-        for (size_t i = 0; i < length; i++)
-        {   
-            for (size_t j = 0; j < length-i-1; j++)
-            {
-                if (*(first+j) < *(first+j+1))
-                {
-                    std::swap(*(first+j), *(first+j+1));
-                }
-            }
-        }
+        notDecreasing( first, last );
+        std::reverse( first, last );
     }
 
     /*!
@@ -69,9 +64,7 @@ namespace sc { // sc = sorting algorithms
     template< typename FwrdIt >
     void random( FwrdIt first, FwrdIt last )
     {
-        unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-        
-        std::shuffle(first, last, std::default_random_engine(seed));
+        std::shuffle(first, last, engine());
     }
 
     /*!
@@ -127,6 +120,264 @@ namespace sc { // sc = sorting algorithms
             std::swap(*(first+i), *(first+i+1));
         }
     }
+
+    /*!
+     * This function arranges the sample (array) so that it holds only a few distinct keys
+     * (16, taken evenly from the original values), in random order.
+     * 
+     * @param first Pointer/iterator to the beginning of the range we wish to arrange.
+     * @param last Pointer/iterator to the location just past the last valid value of the range we wish to arrange.
+     * @tparam FwrdIt A forward iterator to the range we need to arrange.
+     */
+    template< typename FwrdIt >
+    void fewUnique( FwrdIt first, FwrdIt last )
+    {
+        using value_t = typename std::iterator_traits<FwrdIt>::value_type;
+        constexpr size_t N_KEYS = 16;
+
+        size_t length = std::distance( first, last );
+        if ( length == 0 )
+            return;
+
+        std::array<value_t, N_KEYS> keys;
+        for (size_t k = 0; k < N_KEYS; k++)
+            keys[k] = *(first + k*(length-1)/(N_KEYS-1));
+
+        auto rng = engine();
+        std::uniform_int_distribution<size_t> pick( 0, N_KEYS-1 );
+        for (size_t i = 0; i < length; i++)
+            *(first+i) = keys[pick(rng)];
+    }
+
+    /*!
+     * This function arranges the sample (array) so that every element is equal.
+     * 
+     * @param first Pointer/iterator to the beginning of the range we wish to arrange.
+     * @param last Pointer/iterator to the location just past the last valid value of the range we wish to arrange.
+     * @tparam FwrdIt A forward iterator to the range we need to arrange.
+     */
+    template< typename FwrdIt >
+    void allEqual( FwrdIt first, FwrdIt last )
+    {
+        if ( first != last )
+            std::fill( first, last, *first );
+    }
+
+    /*!
+     * Draws ranks in [1, n] with P(k) proportional to 1/k^s in O(1) expected time per
+     * draw, by rejection-inversion (Hörmann & Derflinger, 1996).
+     */
+    class ZipfSampler {
+        private:
+            double m_n, m_s, m_h_x1, m_h_n, m_threshold;
+
+            static double helper1( double x ) { return std::abs(x) > 1e-8 ? std::log1p(x)/x : 1 - x*(0.5 - x*(1.0/3 - 0.25*x)); }
+            static double helper2( double x ) { return std::abs(x) > 1e-8 ? std::expm1(x)/x : 1 + x*0.5*(1 + x*(1.0/3)*(1 + 0.25*x)); }
+
+            double h( double x ) const { return std::exp( -m_s*std::log(x) ); }
+            double h_integral( double x ) const { double lx = std::log(x); return helper2( (1-m_s)*lx ) * lx; }
+            double h_integral_inv( double x ) const { double t = std::max( x*(1-m_s), -1.0 ); return std::exp( helper1(t)*x ); }
+
+        public:
+            ZipfSampler( size_t n, double s = 1.0 ) : m_n( static_cast<double>(n) ), m_s( s ) {
+                m_h_x1 = h_integral( 1.5 ) - 1;
+                m_h_n = h_integral( m_n + 0.5 );
+                m_threshold = 2 - h_integral_inv( h_integral( 2.5 ) - h( 2 ) );
+            }
+
+            template< typename Engine >
+            size_t operator()( Engine &rng ) const {
+                std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+                for (;;)
+                {
+                    double u = m_h_n + unit(rng) * ( m_h_x1 - m_h_n );
+                    double x = h_integral_inv( u );
+                    double k = std::min( std::max( std::floor( x + 0.5 ), 1.0 ), m_n );
+                    if ( k - x <= m_threshold or u >= h_integral( k + 0.5 ) - h( k ) )
+                        return static_cast<size_t>( k );
+                }
+            }
+    };
+
+    /*!
+     * This function arranges the sample (array) with Zipf-distributed keys (s = 1):
+     * the k-th smallest original value appears with frequency proportional to 1/k.
+     * 
+     * @param first Pointer/iterator to the beginning of the range we wish to arrange.
+     * @param last Pointer/iterator to the location just past the last valid value of the range we wish to arrange.
+     * @tparam FwrdIt A forward iterator to the range we need to arrange.
+     */
+    template< typename FwrdIt >
+    void zipf( FwrdIt first, FwrdIt last )
+    {
+        using value_t = typename std::iterator_traits<FwrdIt>::value_type;
+
+        size_t length = std::distance( first, last );
+        if ( length == 0 )
+            return;
+
+        std::vector<value_t> values( first, last );
+        notDecreasing( values.begin(), values.end() );
+
+        auto rng = engine();
+        ZipfSampler rank( length );
+        for (size_t i = 0; i < length; i++)
+            *(first+i) = values[rank(rng)-1];
+    }
+
+    /*!
+     * This function arranges the sample (array) as a sawtooth: about sqrt(n) ascending
+     * runs whose values interleave, so each run spans the whole key range.
+     * 
+     * @param first Pointer/iterator to the beginning of the range we wish to arrange.
+     * @param last Pointer/iterator to the location just past the last valid value of the range we wish to arrange.
+     * @tparam FwrdIt A forward iterator to the range we need to arrange.
+     */
+    template< typename FwrdIt >
+    void sawtooth( FwrdIt first, FwrdIt last )
+    {
+        using value_t = typename std::iterator_traits<FwrdIt>::value_type;
+
+        size_t length = std::distance( first, last );
+        if ( length == 0 )
+            return;
+
+        std::vector<value_t> values( first, last );
+        notDecreasing( values.begin(), values.end() );
+
+        size_t period = std::max<size_t>( static_cast<size_t>( std::sqrt( length ) ), 1 );
+        size_t full_runs = length / period, remainder = length % period;
+
+        // Rank of position i when ordering by (offset inside run, run).
+        for (size_t i = 0; i < length; i++)
+        {
+            size_t run = i / period, offset = i % period;
+            *(first+i) = values[ offset*full_runs + std::min( offset, remainder ) + run ];
+        }
+    }
+
+    /*!
+     * This function arranges the sample (array) as an organ pipe: ascending up to the
+     * middle, then descending.
+     * 
+     * @param first Pointer/iterator to the beginning of the range we wish to arrange.
+     * @param last Pointer/iterator to the location just past the last valid value of the range we wish to arrange.
+     * @tparam FwrdIt A forward iterator to the range we need to arrange.
+     */
+    template< typename FwrdIt >
+    void organPipe( FwrdIt first, FwrdIt last )
+    {
+        using value_t = typename std::iterator_traits<FwrdIt>::value_type;
+
+        size_t length = std::distance( first, last );
+        std::vector<value_t> values( first, last );
+        notDecreasing( values.begin(), values.end() );
+
+        // Even ranks climb from the left, odd ranks climb from the right.
+        size_t left = 0, right = length;
+        for (size_t i = 0; i < length; i++)
+        {
+            if ( i % 2 == 0 )
+                *(first + left++) = values[i];
+            else
+                *(first + --right) = values[i];
+        }
+    }
+
+    /*!
+     * This function arranges the sample (array) with random keys over the whole
+     * non-negative range of the value type, so every decimal digit is in use.
+     * Negative keys are left out because `sa::radix` indexes its `count[]`
+     * buckets with `% 10`, which is negative for them.
+     * 
+     * @param first Pointer/iterator to the beginning of the range we wish to arrange.
+     * @param last Pointer/iterator to the location just past the last valid value of the range we wish to arrange.
+     * @tparam FwrdIt A forward iterator to the range we need to arrange.
+     */
+    template< typename FwrdIt >
+    void randomFullRange( FwrdIt first, FwrdIt last )
+    {
+        using value_t = typename std::iterator_traits<FwrdIt>::value_type;
+
+        auto rng = engine();
+        std::uniform_int_distribution<value_t> dist( 0, std::numeric_limits<value_t>::max() );
+        for (; first != last; ++first)
+            *first = dist(rng);
+    }
+
+    /*!
+     * This function arranges the sample (array) as sorted data with a random tail appended:
+     * 10 percent of the elements, picked at random, are moved to the end in random order.
+     * 
+     * @param first Pointer/iterator to the beginning of the range we wish to arrange.
+     * @param last Pointer/iterator to the location just past the last valid value of the range we wish to arrange.
+     * @tparam FwrdIt A forward iterator to the range we need to arrange.
+     */
+    template< typename FwrdIt >
+    void randomTail( FwrdIt first, FwrdIt last )
+    {
+        using value_t = typename std::iterator_traits<FwrdIt>::value_type;
+
+        size_t length = std::distance( first, last );
+        std::vector<value_t> values( first, last ), tail;
+        notDecreasing( values.begin(), values.end() );
+
+        auto rng = engine();
+        std::bernoulli_distribution to_tail( 0.10 );
+
+        FwrdIt out = first;
+        for (size_t i = 0; i < length; i++)
+        {
+            if ( to_tail(rng) )
+                tail.push_back( values[i] );
+            else
+                *out++ = values[i];
+        }
+        std::shuffle( tail.begin(), tail.end(), rng );
+        std::copy( tail.begin(), tail.end(), out );
+    }
+
+    /*!
+     * This function arranges the sample (array) so that `sa::quick` (median of first,
+     * middle and last, Lomuto partition) picks the second smallest element as pivot at
+     * every level, which makes it quadratic. The partitioning is simulated on positions
+     * only, so building the sequence takes linear time.
+     * 
+     * @param first Pointer/iterator to the beginning of the range we wish to arrange.
+     * @param last Pointer/iterator to the location just past the last valid value of the range we wish to arrange.
+     * @tparam FwrdIt A forward iterator to the range we need to arrange.
+     */
+    template< typename FwrdIt >
+    void medianOf3Killer( FwrdIt first, FwrdIt last )
+    {
+        using value_t = typename std::iterator_traits<FwrdIt>::value_type;
+
+        size_t length = std::distance( first, last );
+        std::vector<value_t> values( first, last );
+        notDecreasing( values.begin(), values.end() );
+
+        // slot[p]: which final position is currently at p during the simulated sort.
+        std::vector<size_t> slot( length ), rank( length );
+        std::iota( slot.begin(), slot.end(), 0 );
+
+        size_t next_rank = 0, lo = 0;
+        while ( length - lo >= 3 )
+        {
+            size_t middle = lo + (length-lo)/2, hi = length-1;
+            // Smallest at `lo` and second smallest at `middle`: the median is `middle`.
+            rank[slot[lo]] = next_rank++;
+            rank[slot[middle]] = next_rank++;
+            // Pivot goes to the end, only `lo` is less than it, then the pivot lands at lo+1.
+            std::swap( slot[middle], slot[hi] );
+            std::swap( slot[lo+1], slot[hi] );
+            lo += 2;
+        }
+        for (; lo < length; lo++)
+            rank[slot[lo]] = next_rank++;
+
+        for (size_t i = 0; i < length; i++)
+            *(first+i) = values[rank[i]];
+    }
 }
 
 #endif //_SCENARIOS_
@@ -0,0 +1,66 @@
+/**
+ * Allocator for the temporary buffers of the sorting algorithms. It goes
+ * through two replaceable hooks, so a harness can route scratch memory (e.g.
+ * to huge pages, see ba::set_policy) without the algorithms depending on it.
+ * @file scratch.h
+ */
+
+#ifndef SCRATCH_H
+#define SCRATCH_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace sa { // sa = sorting algorithms
+    using scratch_alloc_t = void * (*)( size_t bytes );
+    using scratch_free_t = void (*)( void *ptr, size_t bytes );
+
+    /// Hooks used by every scratch buffer; replace both together, before any sort runs.
+    inline scratch_alloc_t scratch_allocate = []( size_t bytes ){ return ::operator new( bytes ); };
+    inline scratch_free_t scratch_deallocate = []( void *ptr, size_t ){ ::operator delete( ptr ); };
+
+    /*!
+     * Standard allocator over the scratch hooks. Elements are default-initialized,
+     * since every scratch buffer is written before it is read.
+     */
+    template < typename T >
+    class ScratchAllocator {
+        public:
+            using value_type = T;
+
+            ScratchAllocator() noexcept = default;
+
+            template < typename U >
+            ScratchAllocator( const ScratchAllocator<U> & ) noexcept {}
+
+            T * allocate( size_t n ) {
+                return static_cast<T *>( scratch_allocate( n * sizeof(T) ) );
+            }
+
+            void deallocate( T *ptr, size_t n ) noexcept {
+                scratch_deallocate( ptr, n * sizeof(T) );
+            }
+
+            template < typename U, typename... Args >
+            void construct( U *ptr, Args&&... args ) {
+                if constexpr ( sizeof...(Args) == 0 )
+                    ::new( static_cast<void *>( ptr ) ) U;
+                else
+                    ::new( static_cast<void *>( ptr ) ) U( std::forward<Args>( args )... );
+            }
+
+            template < typename U >
+            bool operator==( const ScratchAllocator<U> & ) const noexcept { return true; }
+
+            template < typename U >
+            bool operator!=( const ScratchAllocator<U> & ) const noexcept { return false; }
+    };
+
+    /// Vector for algorithm scratch space.
+    template < typename T >
+    using scratch_vector = std::vector<T, ScratchAllocator<T>>;
+}
+
+#endif // SCRATCH_H
@@ -0,0 +1,226 @@
+/**
+ * Selection algorithms (nth element, partial sort and top-k) built on the
+ * partition kernel of the quick sort in sorting.h.
+ * @file selection.h
+ */
+
+#ifndef SELECTION_H
+#define SELECTION_H
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "sorting.h"
+
+namespace sa { // sa = sorting algorithms
+    /// Ranges up to this size are finished with insertion sort.
+    constexpr long SELECTION_CUTOFF = 16;
+
+    //{{{ HEAP SELECT
+    /*!
+     * Moves the element that belongs at `nth` into place with a bounded max-heap
+     * over [first, nth]. Guaranteed O(n log k); used as the introselect fallback.
+     *
+     * @param first The first element in the range we want to reorder.
+     * @param nth The position whose final element we want.
+     * @param last Past the last element in the range we want to reorder.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     */
+    template< typename RandomIt, typename Compare >
+    void heap_select(RandomIt first, RandomIt nth, RandomIt last, Compare cmp)
+    {
+        RandomIt heap_end = nth+1;
+        std::make_heap( first, heap_end, cmp );
+        for ( RandomIt it = heap_end; it < last; it++ )
+        {
+            if ( cmp( *it, *first ) )
+            {
+                std::pop_heap( first, heap_end, cmp );
+                std::swap( *(heap_end-1), *it );
+                std::push_heap( first, heap_end, cmp );
+            }
+        }
+        std::pop_heap( first, heap_end, cmp );
+    }
+    //}}} HEAP SELECT
+
+    /// Partitioning levels allowed before falling back to a heap: 2·log2(n).
+    template< typename RandomIt >
+    int depth_limit_of(RandomIt first, RandomIt last)
+    {
+        int depth_limit = 0;
+        for ( auto n = std::distance( first, last ); n > 1; n >>= 1 )
+            depth_limit += 2;
+        return depth_limit;
+    }
+
+    //{{{ QUICKSELECT
+    /*!
+     * Rearranges [first, last) so that `nth` holds the element it would hold if
+     * the range were sorted, with no element after it **less** than it and no
+     * element before it greater. Hoare's quickselect over `sa::partition`.
+     *
+     * @note Expected O(n), but inherits the worst cases of the partition scheme.
+     *
+     * @param first The first element in the range we want to reorder.
+     * @param nth The position whose final element we want.
+     * @param last Past the last element in the range we want to reorder.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     */
+    template< typename RandomIt, typename Compare >
+    void quickselect(RandomIt first, RandomIt nth, RandomIt last, Compare cmp)
+    {
+        while ( std::distance( first, last ) > SELECTION_CUTOFF )
+        {
+            RandomIt pivot = sa::partition( first, last, last-1, cmp );
+            if ( pivot == nth )
+                return;
+            if ( nth < pivot )
+                last = pivot;
+            else
+                first = pivot+1;
+        }
+        if ( first < last )
+            sa::insertion( first, last, cmp );
+    }
+    //}}} QUICKSELECT
+
+    //{{{ INTROSELECT
+    /**
+     * Same contract as `quickselect`, but falls back to `heap_select` once the
+     * partitioning goes deeper than 2·log2(n) levels, so it stays O(n log n)
+     * on inputs that defeat the median-of-3 pivot.
+     *
+     * @param first The first element in the range we want to reorder.
+     * @param nth The position whose final element we want.
+     * @param last Past the last element in the range we want to reorder.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     */
+    template< typename RandomIt, typename Compare >
+    void introselect(RandomIt first, RandomIt nth, RandomIt last, Compare cmp)
+    {
+        int depth_limit = depth_limit_of( first, last );
+
+        while ( std::distance( first, last ) > SELECTION_CUTOFF )
+        {
+            if ( depth_limit-- == 0 )
+            {
+                heap_select( first, nth, last, cmp );
+                return;
+            }
+            RandomIt pivot = sa::partition( first, last, last-1, cmp );
+            if ( pivot == nth )
+                return;
+            if ( nth < pivot )
+                last = pivot;
+            else
+                first = pivot+1;
+        }
+        if ( first < last )
+            sa::insertion( first, last, cmp );
+    }
+    //}}} INTROSELECT
+
+    //{{{ INTROSORT
+    /**
+     * Quick sort over `sa::partition` that switches to heap sort once the
+     * recursion passes `depth_limit` levels, so duplicate-heavy or adversarial
+     * inputs stay O(n log n). Recurses on the smaller side only.
+     *
+     * @param first The first element in the range we want to reorder.
+     * @param last Past the last element in the range we want to reorder.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     * @param depth_limit Partitioning levels left before the heap sort fallback.
+     */
+    template< typename RandomIt, typename Compare >
+    void introsort(RandomIt first, RandomIt last, Compare cmp, int depth_limit)
+    {
+        while ( std::distance( first, last ) > SELECTION_CUTOFF )
+        {
+            if ( depth_limit-- == 0 )
+            {
+                std::make_heap( first, last, cmp );
+                std::sort_heap( first, last, cmp );
+                return;
+            }
+            RandomIt pivot = sa::partition( first, last, last-1, cmp );
+            if ( pivot - first < last - pivot )
+            {
+                introsort( first, pivot, cmp, depth_limit );
+                first = pivot+1;
+            }
+            else
+            {
+                introsort( pivot+1, last, cmp, depth_limit );
+                last = pivot;
+            }
+        }
+        if ( first < last )
+            sa::insertion( first, last, cmp );
+    }
+    //}}} INTROSORT
+
+    //{{{ PARTIAL SORT
+    /**
+     * Places the `middle - first` smallest elements, sorted, in [first, middle).
+     * The order of the remaining elements is unspecified.
+     *
+     * @param first The first element in the range we want to reorder.
+     * @param middle Past the last element that must end up sorted.
+     * @param last Past the last element in the range we want to reorder.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     */
+    template< typename RandomIt, typename Compare >
+    void partial_sort(RandomIt first, RandomIt middle, RandomIt last, Compare cmp)
+    {
+        if ( middle == first )
+            return;
+        introselect( first, middle-1, last, cmp );
+        introsort( first, middle-1, cmp, depth_limit_of( first, middle-1 ) );
+    }
+    //}}} PARTIAL SORT
+
+    //{{{ HEAP TOP-K
+    /**
+     * Streaming top-k: a single pass over [first, last) keeping the k smallest
+     * elements in a max-heap. The input is not modified, which suits small k
+     * over large or read-only data.
+     *
+     * @param first The first element in the range.
+     * @param last Past the last element in the range.
+     * @param k How many of the smallest elements we want.
+     * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
+     * @return The k smallest elements in non-descending order.
+     */
+    template< typename FwrdIt, typename Compare >
+    std::vector<typename std::iterator_traits<FwrdIt>::value_type>
+    top_k(FwrdIt first, FwrdIt last, size_t k, Compare cmp)
+    {
+        std::vector<typename std::iterator_traits<FwrdIt>::value_type> heap;
+        if ( k == 0 )
+            return heap;
+        heap.reserve( k );
+
+        for ( ; first != last; ++first )
+        {
+            if ( heap.size() < k )
+            {
+                heap.push_back( *first );
+                std::push_heap( heap.begin(), heap.end(), cmp );
+            }
+            else if ( cmp( *first, heap.front() ) )
+            {
+                std::pop_heap( heap.begin(), heap.end(), cmp );
+                heap.back() = *first;
+                std::push_heap( heap.begin(), heap.end(), cmp );
+            }
+        }
+
+        std::sort_heap( heap.begin(), heap.end(), cmp );
+        return heap;
+    }
+    //}}} HEAP TOP-K
+}
+
+#endif // SELECTION_H
@@ -30,6 +30,8 @@ using std::pow;
 using std::string;
 using std::to_string;
 
+#include "scratch.h"
+
 namespace sa { // sa = sorting algorithms
     /// Prints out the range to a string and returns it to the client.
     template <typename FwrdIt>
@@ -58,9 +60,10 @@ namespace sa { // sa = sorting algorithms
     {   
         using myType = typename std::remove_reference<decltype(*std::declval<FwrdIt>())>::type;
         
-        int index, exp=1;
+        int index;
+        myType exp=1;
         size_t arraySize = std::distance( first, last );
-        std::vector <myType> auxiliary(arraySize);
+        sa::scratch_vector <myType> auxiliary(arraySize);
 
         // Make a copy of elements in [first, last) range to vector auxiliary.
         std::copy( first, last, auxiliary.begin() );
@@ -89,6 +92,9 @@ namespace sa { // sa = sorting algorithms
             for (index=0; index<(static_cast<int> (arraySize)); index++)
                 *(first+index) = auxiliary[index];
 
+            // Stop before `exp` overflows on keys that use every decimal digit of the type.
+            if ( largest/exp < 10 )
+                break;
             exp *= 10;
         }
     }
@@ -180,7 +186,9 @@ namespace sa { // sa = sorting algorithms
     template< typename RandomIt, typename Compare >
     void shell(RandomIt first, RandomIt last, Compare cmp)
     {
-        int length = std::distance( first, last ), interval, i, auxiliary, j;
+        using myType = typename std::remove_reference<decltype(*std::declval<RandomIt>())>::type;
+
+        int length = std::distance( first, last ), interval = 1, i, j;
 
         while ( interval < length ) 
         {
@@ -192,7 +200,7 @@ namespace sa { // sa = sorting algorithms
             interval /= 3;
             for ( i = interval; i < length; i++ ) 
             {
-                auxiliary = *(first + i);
+                myType auxiliary = *(first + i);
                 for ( j = i; j >= interval && cmp(auxiliary, *(first+(j-interval))); j-=interval ) 
                 {   
                     *(first + j) = *(first + (j-interval));
@@ -214,10 +222,10 @@ namespace sa { // sa = sorting algorithms
      * @param A The first element in the range we want to reorder.
      * @param cmp A comparison function that returns true if the first parameter is **less** than the second.
      */
-    template< typename FwrdIt, typename Compare >
+    template< typename FwrdIt, typename OutIt, typename Compare >
     void mergeSort( FwrdIt L, FwrdIt l_last, // [L; l_last)
          FwrdIt R, FwrdIt r_last, // [R; r_last)
-         FwrdIt A, Compare cmp)
+         OutIt A, Compare cmp)
     {
         size_t sizeArrayLeft = std::distance( L, l_last ), 
                 sizeArrayRight = std::distance( R, r_last ), 
@@ -267,8 +275,8 @@ namespace sa { // sa = sorting algorithms
             size_t L_sz = length/2;
             size_t R_sz = length - L_sz;
 
-            std::vector<myType> L( L_sz );
-            std::vector<myType> R( R_sz );
+            sa::scratch_vector<myType> L( L_sz );
+            sa::scratch_vector<myType> R( R_sz );
  
             std::copy( first, first+L_sz, L.begin() );
             std::copy( first+L_sz, last, R.begin() );
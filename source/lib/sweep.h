@@ -0,0 +1,138 @@
+/**
+ * Sample-size planning for the benchmark sweeps: linear, geometric and
+ * cache-aware sequences of sizes, plus the cache level each size fits in.
+ * @file sweep.h
+ */
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace sw { // sw = size sweep
+    /// A data (or unified) cache level as reported by the kernel.
+    struct CacheLevel {
+        int level;      //!< 1 for L1, 2 for L2, ...
+        size_t bytes;   //!< Capacity in bytes.
+    };
+
+    enum sweep_t {
+        LINEAR = 0,      //!< Evenly spaced sizes (the original behaviour).
+        GEOMETRIC = 1,   //!< Sizes with a constant ratio between neighbours.
+        CACHE_AWARE = 2, //!< Geometric sizes plus dense points around every cache boundary.
+    };
+
+    /// Parses sysfs sizes such as "48K", "2048K" or "32M".
+    inline size_t parse_size( const std::string &text )
+    {
+        size_t value = std::stoul( text );
+        switch ( text.back() )
+        {
+            case 'K': return value << 10;
+            case 'M': return value << 20;
+            case 'G': return value << 30;
+            default:  return value;
+        }
+    }
+
+    /*!
+     * Reads the data and unified caches of cpu0 from `/sys/devices/system/cpu`,
+     * ordered by level. Instruction caches are ignored. Returns an empty list
+     * when sysfs is not available.
+     */
+    inline std::vector<CacheLevel> cache_levels( void )
+    {
+        std::vector<CacheLevel> levels;
+        const std::string base = "/sys/devices/system/cpu/cpu0/cache/index";
+
+        for ( int index = 0; ; index++ )
+        {
+            std::ifstream level_file( base + std::to_string(index) + "/level" );
+            if ( not level_file )
+                break;
+
+            std::string type, size;
+            int level;
+            level_file >> level;
+            std::ifstream( base + std::to_string(index) + "/type" ) >> type;
+            std::ifstream( base + std::to_string(index) + "/size" ) >> size;
+
+            if ( type == "Instruction" or size.empty() )
+                continue;
+            levels.push_back( { level, parse_size( size ) } );
+        }
+
+        std::sort( levels.begin(), levels.end(),
+                   []( const CacheLevel &a, const CacheLevel &b ){ return a.level < b.level; } );
+        return levels;
+    }
+
+    /// Name of the smallest cache that holds `bytes` ("L1", "L2", ...), or "DRAM".
+    inline std::string cache_level_of( size_t bytes, const std::vector<CacheLevel> &levels )
+    {
+        for ( const auto &cache : levels )
+            if ( bytes <= cache.bytes )
+                return "L" + std::to_string( cache.level );
+        return "DRAM";
+    }
+
+    /// Keeps the sizes within [min_sz, max_sz], without repetitions, largest first.
+    inline std::vector<size_t> normalize( std::vector<size_t> sizes, size_t min_sz, size_t max_sz )
+    {
+        sizes.erase( std::remove_if( sizes.begin(), sizes.end(),
+                                     [=]( size_t n ){ return n < min_sz or n > max_sz or n == 0; } ),
+                     sizes.end() );
+        std::sort( sizes.begin(), sizes.end(), std::greater<size_t>() );
+        sizes.erase( std::unique( sizes.begin(), sizes.end() ), sizes.end() );
+        return sizes;
+    }
+
+    /// `n_samples` evenly spaced sizes from `max_sz` down to `min_sz`.
+    inline std::vector<size_t> linear( size_t min_sz, size_t max_sz, int n_samples )
+    {
+        std::vector<size_t> sizes;
+        double step = n_samples > 1 ? static_cast<double>(max_sz - min_sz) / (n_samples-1) : 0.0;
+        for ( int i = 0; i < n_samples; i++ )
+            sizes.push_back( max_sz - static_cast<size_t>( std::llround( i*step ) ) );
+        return normalize( sizes, min_sz, max_sz );
+    }
+
+    /// `n_samples` sizes from `max_sz` down to `min_sz` with a constant ratio between neighbours.
+    inline std::vector<size_t> geometric( size_t min_sz, size_t max_sz, int n_samples )
+    {
+        std::vector<size_t> sizes;
+        double lo = std::log( static_cast<double>( std::max<size_t>( min_sz, 1 ) ) );
+        double hi = std::log( static_cast<double>( max_sz ) );
+        double step = n_samples > 1 ? (hi - lo) / (n_samples-1) : 0.0;
+        for ( int i = 0; i < n_samples; i++ )
+            sizes.push_back( static_cast<size_t>( std::llround( std::exp( hi - i*step ) ) ) );
+        return normalize( sizes, min_sz, max_sz );
+    }
+
+    /*!
+     * Geometric sizes plus a dense cluster of points around the number of
+     * `elem_size`-byte elements that fill each cache level, so the transitions
+     * L1 -> L2 -> L3 -> DRAM show up in the curves.
+     */
+    inline std::vector<size_t> cache_aware( size_t min_sz, size_t max_sz, int n_samples,
+                                            size_t elem_size, const std::vector<CacheLevel> &levels )
+    {
+        static const double around[] = { 0.5, 0.7, 0.85, 0.95, 1.0, 1.05, 1.15, 1.4, 2.0 };
+
+        std::vector<size_t> sizes = geometric( min_sz, max_sz, n_samples );
+        for ( const auto &cache : levels )
+        {
+            double boundary = static_cast<double>( cache.bytes ) / elem_size;
+            for ( double factor : around )
+                sizes.push_back( static_cast<size_t>( boundary * factor ) );
+        }
+        return normalize( sizes, min_sz, max_sz );
+    }
+}
+
+#endif // SWEEP_H
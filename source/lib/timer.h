@@ -0,0 +1,140 @@
+/**
+ * Interval timers for the benchmark: `std::chrono::steady_clock` or the
+ * invariant time-stamp counter, calibrated to nanoseconds at construction,
+ * with the cost of an empty start/stop pair measured so it can be subtracted.
+ * @file timer.h
+ */
+
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define CT_HAS_TSC 1
+#else
+#define CT_HAS_TSC 0
+#endif
+
+namespace ct { // ct = cycle timer
+    enum backend_t {
+        STEADY = 0,  //!< `std::chrono::steady_clock`.
+        TSC = 1,     //!< `rdtsc`/`rdtscp` fenced with `lfence`.
+    };
+
+#if CT_HAS_TSC
+    /// True if the CPU reports a constant-rate TSC that keeps ticking in deep C-states.
+    inline bool invariant_tsc( void )
+    {
+        unsigned eax, ebx, ecx, edx;
+        if ( __get_cpuid( 0x80000000, &eax, &ebx, &ecx, &edx ) == 0 or eax < 0x80000007 )
+            return false;
+        __get_cpuid( 0x80000007, &eax, &ebx, &ecx, &edx );
+        return ( edx >> 8 ) & 1;
+    }
+
+    /// Reads the TSC after every earlier instruction has completed.
+    inline uint64_t tsc_start( void )
+    {
+        _mm_lfence();
+        uint64_t t = __rdtsc();
+        _mm_lfence();
+        return t;
+    }
+
+    /// Reads the TSC once the measured code has retired; later code waits for the read.
+    inline uint64_t tsc_stop( void )
+    {
+        unsigned aux;
+        uint64_t t = __rdtscp( &aux );
+        _mm_lfence();
+        return t;
+    }
+#else
+    inline bool invariant_tsc( void ) { return false; }
+    inline uint64_t tsc_start( void ) { return 0; }
+    inline uint64_t tsc_stop( void ) { return 0; }
+#endif
+
+    /*!
+     * Timer that returns raw ticks from `start()`/`stop()` and converts their
+     * difference to nanoseconds. Falls back to the steady clock when the TSC is
+     * not invariant, since its rate would then follow the CPU frequency.
+     */
+    class Timer {
+        private:
+            short m_backend;
+            double m_ns_per_tick{1.0};
+            double m_overhead_ns{0.0};
+
+            /// Measures TSC ticks against the steady clock over `window`.
+            void calibrate( std::chrono::milliseconds window ) {
+                auto c0 = std::chrono::steady_clock::now();
+                uint64_t t0 = tsc_start();
+                while ( std::chrono::steady_clock::now() - c0 < window )
+                    ;
+                uint64_t t1 = tsc_stop();
+                auto c1 = std::chrono::steady_clock::now();
+                m_ns_per_tick = std::chrono::duration<double, std::nano>( c1 - c0 ).count() / ( t1 - t0 );
+            }
+
+            /// Smallest duration of an empty start/stop pair.
+            void measure_overhead( void ) {
+                double best = -1.0;
+                for ( int i = 0; i < 10000; i++ )
+                {
+                    uint64_t t0 = start();
+                    uint64_t t1 = stop();
+                    double ns = ( t1 - t0 ) * m_ns_per_tick;
+                    if ( best < 0 or ns < best )
+                        best = ns;
+                }
+                m_overhead_ns = best;
+            }
+
+        public:
+            explicit Timer( short backend = STEADY ) : m_backend( backend ) {
+                if ( m_backend == TSC and not invariant_tsc() )
+                {
+                    std::cerr << "timer: no invariant TSC, using steady_clock\n";
+                    m_backend = STEADY;
+                }
+                if ( m_backend == TSC )
+                    calibrate( std::chrono::milliseconds( 100 ) );
+                measure_overhead();
+            }
+
+            uint64_t start( void ) const {
+                if ( m_backend == TSC )
+                    return tsc_start();
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch() ).count();
+            }
+
+            uint64_t stop( void ) const {
+                if ( m_backend == TSC )
+                    return tsc_stop();
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch() ).count();
+            }
+
+            /// Nanoseconds between two readings, minus the calibrated cost of reading the timer.
+            double elapsed_ns( uint64_t t0, uint64_t t1 ) const {
+                return std::max( ( t1 - t0 ) * m_ns_per_tick - m_overhead_ns, 0.0 );
+            }
+
+            short backend( void ) const { return m_backend; }
+
+            /// Backend actually in use, as written to the result files.
+            const char * name( void ) const { return m_backend == TSC ? "tsc" : "steady"; }
+
+            double overhead_ns( void ) const { return m_overhead_ns; }
+    };
+}
+
+#endif // TIMER_H
@@ -0,0 +1,174 @@
+/**
+ * Phase-level tracing: scoped spans recorded into per-thread ring buffers and
+ * exported as Chrome trace JSON, which opens in Perfetto or chrome://tracing.
+ * @file trace.h
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace tr { // tr = tracing
+    /// Spans are only recorded while this is set; a disabled span costs one branch.
+    inline bool enabled = false;
+
+    /// Events kept per thread; older ones are overwritten.
+    constexpr size_t RING_CAPACITY = size_t{1} << 16;
+
+    /// One completed span.
+    struct Event {
+        char name[48];      //!< Copied, so callers may pass temporaries.
+        const char *cat;    //!< Category; must be a string literal.
+        uint64_t ts_ns;     //!< Start, relative to `epoch()`.
+        uint64_t dur_ns;    //!< Duration.
+        int64_t arg;        //!< Optional numeric argument (e.g. sample size), -1 if absent.
+    };
+
+    /// Events of one thread. Only its owner writes; the exporter reads after the work is done.
+    struct ThreadBuffer {
+        std::vector<Event> events;
+        size_t total{0};    //!< Events ever recorded; the ring holds the last RING_CAPACITY.
+        int tid;
+
+        explicit ThreadBuffer( int id ) : events( RING_CAPACITY ), tid( id ) {}
+
+        void push( const Event &event ) {
+            events[total % RING_CAPACITY] = event;
+            total++;
+        }
+    };
+
+    /// Every thread buffer created so far, kept alive until export.
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    };
+
+    inline Registry & registry( void )
+    {
+        static Registry instance;
+        return instance;
+    }
+
+    /// Buffer of the calling thread, registered on first use.
+    inline ThreadBuffer & local_buffer( void )
+    {
+        thread_local std::shared_ptr<ThreadBuffer> buffer = []{
+            Registry &reg = registry();
+            std::lock_guard<std::mutex> lock( reg.mutex );
+            reg.buffers.push_back( std::make_shared<ThreadBuffer>( static_cast<int>( reg.buffers.size() ) + 1 ) );
+            return reg.buffers.back();
+        }();
+        return *buffer;
+    }
+
+    /// Common time origin of all events.
+    inline std::chrono::steady_clock::time_point epoch( void )
+    {
+        static const auto start = std::chrono::steady_clock::now();
+        return start;
+    }
+
+    inline uint64_t now_ns( void )
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - epoch() ).count();
+    }
+
+    /*!
+     * Records the lifetime of the object as a span named `name` (optionally
+     * followed by `detail`) in category `cat`.
+     */
+    class Span {
+        private:
+            Event m_event;
+            bool m_active;
+
+        public:
+            Span( const char *name, const char *cat = "phase", int64_t arg = -1, const char *detail = nullptr )
+                : m_active( enabled ) {
+                if ( not m_active )
+                    return;
+                if ( detail != nullptr )
+                    std::snprintf( m_event.name, sizeof(m_event.name), "%s %s", name, detail );
+                else
+                    std::snprintf( m_event.name, sizeof(m_event.name), "%s", name );
+                m_event.cat = cat;
+                m_event.arg = arg;
+                m_event.ts_ns = now_ns();
+            }
+
+            ~Span() {
+                if ( not m_active )
+                    return;
+                m_event.dur_ns = now_ns() - m_event.ts_ns;
+                local_buffer().push( m_event );
+            }
+
+            Span( const Span& ) = delete;
+            Span& operator=( const Span& ) = delete;
+    };
+
+    /// Escapes the characters JSON strings cannot hold verbatim.
+    inline std::string json_escape( const char *text )
+    {
+        std::string out;
+        for ( ; *text; ++text )
+        {
+            if ( *text == '"' or *text == '\\' )
+                out += '\\';
+            if ( static_cast<unsigned char>( *text ) >= 0x20 )
+                out += *text;
+        }
+        return out;
+    }
+
+    /*!
+     * Writes every recorded span to `path` as Chrome trace JSON ("X" complete
+     * events, timestamps in microseconds). Call once the traced work is finished.
+     *
+     * @return false if the file could not be written.
+     */
+    inline bool write_chrome_trace( const std::string &path )
+    {
+        std::ofstream out( path );
+        if ( not out )
+            return false;
+
+        Registry &reg = registry();
+        std::lock_guard<std::mutex> lock( reg.mutex );
+
+        out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+        char number[64];
+        for ( const auto &buffer : reg.buffers )
+        {
+            size_t count = std::min( buffer->total, RING_CAPACITY );
+            for ( size_t i = buffer->total - count; i < buffer->total; i++ )
+            {
+                const Event &event = buffer->events[i % RING_CAPACITY];
+                out << ( first ? "\n" : ",\n" );
+                first = false;
+                std::snprintf( number, sizeof(number), "%.3f,\"dur\":%.3f", event.ts_ns / 1e3, event.dur_ns / 1e3 );
+                out << "{\"name\":\"" << json_escape( event.name ) << "\",\"cat\":\"" << event.cat
+                    << "\",\"ph\":\"X\",\"ts\":" << number << ",\"pid\":1,\"tid\":" << buffer->tid;
+                if ( event.arg >= 0 )
+                    out << ",\"args\":{\"n\":" << event.arg << "}";
+                out << "}";
+            }
+        }
+        out << "\n]}\n";
+        return static_cast<bool>( out );
+    }
+}
+
+#endif // TRACE_H
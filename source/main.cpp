@@ -1,9 +1,15 @@
 /**
- * g++ -Wall -pedantic -std=c++17 -fsanitize=address -o bin/analisysEmpirical
- * source/main.cpp source/lib/sorting.h source/lib/scenarios.h
- * source/lib/ClassDataScenarios.h source/lib/ClassSortingCollection.h
+ * g++ -Wall -pedantic -std=c++17 -O2 -fsanitize=address -o bin/analisysEmpirical
+ * source/main.cpp source/lib/memtrack.cpp source/lib/sorting.h source/lib/scenarios.h
+ * source/lib/ClassDataScenarios.h source/lib/ClassSortingCollection.h -ltbb
+ * (drop -ltbb when TBB is not installed; the parallel baselines then run serially)
  * 
  * ./bin/analisysEmpirical 10 50 5 1 1 2
+ *
+ * Optional trailing arguments, in order: sweep mode (sw::sweep_t), allocation
+ * policy (ba::policy_t), timer backend (ct::backend_t), batch threshold in elements,
+ * scenario seed, Chrome trace output path.
+ * ./bin/analisysEmpirical 10 50000 20 16 4 5 2 0 1 100000
  */
 #include <iostream>
 #include <iomanip>
@@ -21,11 +27,15 @@ using std::function;
 #include "lib/sorting.h"
 #include "lib/ClassDataScenarios.h"
 #include "lib/ClassSortingCollection.h"
+#include "lib/memtrack.h"
+#include "lib/sweep.h"
+#include "lib/allocator.h"
+#include "lib/timer.h"
+#include "lib/trace.h"
 
 
 using value_type = long int;
 using size_type = long int;
-using duration_t = std::chrono::duration<double>;
 
 
 constexpr short FIELD_WIDTH = 20;
@@ -39,14 +49,35 @@ struct RunningOpt{
     short which_algs{1};          //!< Bit code for the chosen algorithms to run.
     short which_scenarios{1};     //!< Bit code for the chosen scenarios to run.
     short n_runs{5};              //!< Number of rounds for each size.
+    short sweep{sw::LINEAR};      //!< How sample sizes are spread (see sw::sweep_t).
+    short alloc_policy{ba::DEFAULT}; //!< Bit code for how benchmark buffers are allocated (see ba::policy_t).
+    short timer{ct::STEADY};      //!< Timing backend (see ct::backend_t).
+    size_t batch_elems{0};        //!< Below this many elements, sort several staged copies per timer read (0 = off).
+    unsigned long seed{sc::seed}; //!< Seed for the randomized scenarios.
+    std::string trace_path;       //!< Chrome trace JSON written here when set.
 
-    size_type sample_step(void){
-        return static_cast<float>(max_sample_sz-min_sample_sz)/(n_samples-1);
+    /// Number of independent copies sorted back-to-back per timer read at `sample_sz`.
+    size_t batch_size( size_t sample_sz ) const {
+        if ( sample_sz == 0 or sample_sz >= batch_elems )
+            return 1;
+        return ( batch_elems + sample_sz - 1 ) / sample_sz;
+    }
+
+    /// Sample sizes to run, largest first.
+    std::vector<size_t> sample_sizes( const std::vector<sw::CacheLevel> &caches ) const {
+        switch ( sweep ) {
+            case sw::GEOMETRIC:
+                return sw::geometric( min_sample_sz, max_sample_sz, n_samples );
+            case sw::CACHE_AWARE:
+                return sw::cache_aware( min_sample_sz, max_sample_sz, n_samples, sizeof(value_type), caches );
+            default:
+                return sw::linear( min_sample_sz, max_sample_sz, n_samples );
+        }
     }
 };
 
 
-constexpr bool compare( const int&a, const int &b ){
+constexpr bool compare( const value_type &a, const value_type &b ){
     return ( a < b );
 }
 
@@ -66,36 +97,76 @@ int main( int argc, char * argv[] ){
         run_opt.which_scenarios = std::stoi(argv[5]);
     if ( argv[6] )
         run_opt.n_runs = std::stoi(argv[6]);
+    if ( argc > 7 )
+        run_opt.sweep = std::stoi(argv[7]);
+    if ( argc > 8 )
+        run_opt.alloc_policy = std::stoi(argv[8]);
+    if ( argc > 9 )
+        run_opt.timer = std::stoi(argv[9]);
+    if ( argc > 10 )
+        run_opt.batch_elems = std::stoul(argv[10]);
+    if ( argc > 11 )
+        run_opt.seed = std::stoul(argv[11]);
+    if ( argc > 12 )
+        run_opt.trace_path = argv[12];
+
+    sc::seed = run_opt.seed;
+    // Pass this back as argv[11] to regenerate the same scenario data.
+    std::cout << "seed: " << sc::seed << "\n";
+    tr::enabled = not run_opt.trace_path.empty();
+
+    // Must precede DataScenarios: its buffers take the policy when they are created.
+    ba::set_policy( run_opt.alloc_policy );
+    ct::Timer timer{ run_opt.timer };
+    std::cout << "timer: " << timer.name() << ", overhead " << timer.overhead_ns() << " ns\n";
 
     bool printed_header;
-    size_type sample_step(run_opt.sample_step());
+    auto caches = sw::cache_levels();
+    auto sample_sizes = run_opt.sample_sizes( caches );
 
     DataScenarios<long int> scenariosSet{run_opt.min_sample_sz, run_opt.max_sample_sz, run_opt.which_scenarios};
     scenariosSet.start();
 
-    using MyIt = std::vector<value_type>::iterator;
-    SortingCollection<value_type, MyIt, bool (*)(const int&, const int&)> sort_algs{ run_opt.which_algs };
+    using MyIt = DataScenarios<value_type>::iterator;
+    SortingCollection<value_type, MyIt, bool (*)(const value_type&, const value_type&)> sort_algs{ run_opt.which_algs };
 
 
     // FOR EACH DATA SCENARIO DO...
     while(not scenariosSet.has_ended())
     {
+        tr::Span scenario_span( "scenario", "harness", -1, scenariosSet.name().c_str() );
         scenariosSet.reset();
         printed_header = false;
 
-        std::stringstream headerFile, bodyFile, bodyLine;
-        headerFile << "size" << ",";
+        std::stringstream headerFile, bodyFile, bodyLine, memoryFile, ratioFile;
+        headerFile << "size" << "," << "cache_level" << "," << "batch" << "," << "timer" << "," << "timer_overhead_ns" << ",";
+        memoryFile << "size,algorithm,batch,allocations,bytes_allocated,peak_live_bytes,rss_delta_kb";
                                
         std::ofstream file;
         std::string fileName = "data/" + scenariosSet.name() + ".csv";
         file.open( fileName.c_str() );
 
         // FOR EACH SAMPLE SIZE DO...
-        for ( auto ns{1} ; ns < run_opt.n_samples ; ++ns )
+        for ( auto sample_sz : sample_sizes )
         {
+            tr::Span sample_span( "sample", "harness", sample_sz );
+            scenariosSet.sample(sample_sz);
             scenariosSet.runScenery();
+            // Independent copies of the sample, sorted one after the other inside a single timed region.
+            size_t batch = run_opt.batch_size( sample_sz );
+            ba::vector<value_type> staged( batch > 1 ? batch*sample_sz : 0 );
+
+            // Times are per copy; the batch factor and timer identify how they were measured.
+            std::stringstream rowPrefix;
+            rowPrefix << sample_sz << "," << sw::cache_level_of( sample_sz*sizeof(value_type), caches ) << ","
+                      << batch << "," << timer.name() << ","
+                      << std::fixed << std::setprecision(PRECISION) << timer.overhead_ns() << ",";
+
             bodyLine.str("");
-            bodyLine << run_opt.max_sample_sz - ((ns-1)*sample_step) << ",";
+            bodyLine << rowPrefix.str();
+
+            std::vector<double> row_ns;
+            double best_baseline_ns = 0.0;
 
             sort_algs.start();
 
@@ -106,26 +177,71 @@ int main( int argc, char * argv[] ){
                     headerFile << sort_algs.name() << ",";
                 }
 
-                duration_t elapsed_time_mean{0.0};
+                std::string alg_name = sort_algs.name();
+                tr::Span cell_span( "cell", "cell", sample_sz, alg_name.c_str() );
+
+                double elapsed_ns_mean{0.0};
                 auto sorting = sort_algs.algorithm();
+
+                // Restores the sample, and the staged copies in batched mode.
+                auto prepare = [&]( void ){
+                    scenariosSet.reset();
+                    if ( batch > 1 ) {
+                        tr::Span stage_span( "stage", "harness", sample_sz );
+                        for ( size_t b = 0; b < staged.size(); b += sample_sz )
+                            std::copy( scenariosSet.begin_data(), scenariosSet.end_data(), staged.begin() + b );
+                    }
+                };
+                auto sort_all = [&]( void ){
+                    if ( batch > 1 ) {
+                        for ( size_t b = 0; b < staged.size(); b += sample_sz )
+                            sorting(staged.begin() + b, staged.begin() + b + sample_sz, compare);
+                    }
+                    else
+                        sorting(scenariosSet.begin_data(), scenariosSet.end_data(), compare);
+                };
+
+                // Untimed pass with allocation counting on, run first so the RSS delta sees the first touch.
+                prepare();
+                mt::MemScope mem_scope;
+                mem_scope.begin();
+                {
+                    tr::Span memory_span( "memory", "sort", sample_sz, alg_name.c_str() );
+                    sort_all();
+                }
+                mt::MemStats memory = mem_scope.end();
                 
                 // FOR EACH RUN DO...This is necessary to reduce any measurement noise.
                 for( auto ct_run(0) ; ct_run < run_opt.n_runs ; ++ct_run )
                 {
-                    scenariosSet.reset();
+                    prepare();
 
-                    auto start = std::chrono::steady_clock::now();
-                    sorting(scenariosSet.begin_data(), scenariosSet.end_data(), compare);
-                    auto end = std::chrono::steady_clock::now();
+                    uint64_t start, end;
+                    {
+                        tr::Span sort_span( "sort", "sort", sample_sz, alg_name.c_str() );
+                        start = timer.start();
+                        sort_all();
+                        end = timer.stop();
+                    }
 
-                    auto diff( end - start );
+                    double diff = timer.elapsed_ns( start, end ) / batch;
 
-                    elapsed_time_mean = elapsed_time_mean + (  diff - elapsed_time_mean ) 
+                    elapsed_ns_mean = elapsed_ns_mean + (  diff - elapsed_ns_mean ) 
                                         / static_cast<double>(ct_run+1);
                 }
                 
-                bodyLine << std::fixed << std::setprecision(PRECISION)
-                         << std::chrono::duration <double, std::nano> (elapsed_time_mean).count() << ",";
+                double elapsed_ns = elapsed_ns_mean;
+                tr::Span format_span( "format", "csv", sample_sz );
+                bodyLine << std::fixed << std::setprecision(PRECISION) << elapsed_ns << ",";
+
+                row_ns.push_back( elapsed_ns );
+                if ( sort_algs.is_baseline() and ( best_baseline_ns == 0.0 or elapsed_ns < best_baseline_ns ) )
+                    best_baseline_ns = elapsed_ns;
+
+                // Counts cover the whole batch of `batch` copies, unlike the per-copy times.
+                memoryFile << "\n" << sample_sz << "," << alg_name << "," << batch << ","
+                           << memory.allocs << "," << memory.bytes << ","
+                           << memory.peak_bytes << "," << memory.rss_delta_kb;
 
                 sort_algs.next();
             }
@@ -133,16 +249,35 @@ int main( int argc, char * argv[] ){
             bodyFile << "\n" << bodyLine.str();
             printed_header = true;
 
-            scenariosSet.decrease(sample_step);
+            // Every time as a multiple of the fastest toolchain baseline of the same row.
+            if ( best_baseline_ns > 0.0 ) {
+                ratioFile << "\n" << rowPrefix.str();
+                for ( double ns : row_ns )
+                    ratioFile << std::fixed << std::setprecision(PRECISION) << ns / best_baseline_ns << ",";
+            }
         }
 
+        tr::Span write_span( "write", "csv" );
         file << headerFile.str();
         file << bodyFile.str();
         file.close();
+
+        std::ofstream mem_file( "data/" + scenariosSet.name() + "_memory.csv" );
+        mem_file << memoryFile.str();
+        mem_file.close();
+
+        if ( not ratioFile.str().empty() ) {
+            std::ofstream ratio_file( "data/" + scenariosSet.name() + "_ratio.csv" );
+            ratio_file << headerFile.str() << ratioFile.str();
+            ratio_file.close();
+        }
         
         scenariosSet.next();
     }
 
+    if ( tr::enabled and not tr::write_chrome_trace( run_opt.trace_path ) )
+        std::cerr << "could not write trace to " << run_opt.trace_path << "\n";
+
     return 0;
 }
 
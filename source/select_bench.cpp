@@ -0,0 +1,166 @@
+/**
+ * Compares the selection algorithms against a full sort followed by truncation
+ * over several k values and the data scenarios.
+ *
+ * g++ -Wall -pedantic -std=c++17 -O2 -o bin/selectBench source/select_bench.cpp -ltbb
+ * (drop -ltbb when TBB is not installed; the parallel baselines then run serially)
+ *
+ * ./bin/selectBench 20000 63 16 3
+ *   argv[1] sample size, argv[2] bit code for the scenarios,
+ *   argv[3] bit code of the full-sort baseline, argv[4] runs per cell.
+ */
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cassert>
+#include <algorithm>
+
+#include "lib/sorting.h"
+#include "lib/selection.h"
+#include "lib/ClassDataScenarios.h"
+#include "lib/ClassSortingCollection.h"
+
+
+using value_type = long int;
+using duration_t = std::chrono::duration<double>;
+
+
+constexpr short PRECISION = 2;
+
+
+struct RunningOpt{
+    size_t sample_sz{20000};     //!< Number of elements per run.
+    short which_scenarios{63};   //!< Bit code for the chosen scenarios to run.
+    short full_sort{16};         //!< Bit code of the full-sort baseline (quick).
+    short n_runs{3};             //!< Number of rounds for each cell.
+};
+
+
+constexpr bool compare( const value_type &a, const value_type &b ){
+    return ( a < b );
+}
+
+
+/*!
+ * Mean time in nanoseconds of `run` over `n_runs` rounds, restoring the
+ * scenario data before each round. `verify` checks each round's result after
+ * the clock has stopped, so checks of different cost do not skew the columns.
+ */
+template < typename Scenarios, typename Run, typename Verify >
+double mean_ns( Scenarios &scenariosSet, short n_runs, Run run, Verify verify )
+{
+    duration_t elapsed_time_mean{0.0};
+    for ( auto ct_run(0) ; ct_run < n_runs ; ++ct_run )
+    {
+        scenariosSet.reset();
+        auto start = std::chrono::steady_clock::now();
+        run( scenariosSet.begin_data(), scenariosSet.end_data() );
+        auto end = std::chrono::steady_clock::now();
+        verify( scenariosSet.begin_data(), scenariosSet.end_data() );
+        elapsed_time_mean = elapsed_time_mean + ( (end - start) - elapsed_time_mean ) / static_cast<double>(ct_run+1);
+    }
+    return std::chrono::duration<double, std::nano>(elapsed_time_mean).count();
+}
+
+
+int main( int argc, char * argv[] ){
+    RunningOpt run_opt;
+
+    if ( argc > 1 )
+        run_opt.sample_sz = std::stoul(argv[1]);
+    if ( argc > 2 )
+        run_opt.which_scenarios = std::stoi(argv[2]);
+    if ( argc > 3 )
+        run_opt.full_sort = std::stoi(argv[3]);
+    if ( argc > 4 )
+        run_opt.n_runs = std::stoi(argv[4]);
+
+    using MyIt = DataScenarios<value_type>::iterator;
+    SortingCollection<value_type, MyIt, bool (*)(const value_type&, const value_type&)> sort_algs{ run_opt.full_sort };
+    if ( sort_algs.has_ended() )
+    {
+        std::cerr << "no algorithm selected by bit code " << run_opt.full_sort << "\n";
+        return 1;
+    }
+    auto full_sort = sort_algs.algorithm();
+
+    size_t n = run_opt.sample_sz;
+    std::vector<size_t> k_values{ 1, 10, 100, n/100, n/10, n/2, n };
+    k_values.erase( std::remove_if( k_values.begin(), k_values.end(), [n]( size_t k ){ return k == 0 or k > n; } ),
+                    k_values.end() );
+    std::sort( k_values.begin(), k_values.end() );
+    k_values.erase( std::unique( k_values.begin(), k_values.end() ), k_values.end() );
+
+    DataScenarios<value_type> scenariosSet{0, run_opt.sample_sz, run_opt.which_scenarios};
+    scenariosSet.start();
+
+    // FOR EACH DATA SCENARIO DO...
+    while ( not scenariosSet.has_ended() )
+    {
+        scenariosSet.runScenery();
+
+        std::stringstream bodyFile;
+        bodyFile << "k," << sort_algs.name() << "_truncate,quickselect,introselect,partial_sort,heap_top_k";
+
+        // FOR EACH K DO...
+        for ( size_t k : k_values )
+        {
+            // The k smallest, staged once per k outside the timed region.
+            scenariosSet.reset();
+            std::vector<value_type> expected( scenariosSet.begin_data(), scenariosSet.end_data() );
+            std::sort( expected.begin(), expected.end(), compare );
+            expected.resize( k );
+
+            // Filled by the timed runs; `result` is reserved so the truncation copy never allocates.
+            std::vector<value_type> result;
+            result.reserve( n );
+
+            auto nth_ok = [&]( MyIt first, MyIt ){
+                assert( *(first+(k-1)) == expected.back() );
+                (void) first;
+            };
+            auto prefix_ok = [&]( MyIt first, MyIt ){
+                assert( std::equal( expected.begin(), expected.end(), first ) );
+                (void) first;
+            };
+            auto result_ok = [&]( MyIt, MyIt ){
+                assert( result == expected );
+            };
+
+            // Baseline: full sort, then copy out the first k.
+            double full_ns = mean_ns( scenariosSet, run_opt.n_runs, [&]( MyIt first, MyIt last ){
+                full_sort( first, last, compare );
+                result.assign( first, first+k );
+            }, result_ok );
+            double quick_ns = mean_ns( scenariosSet, run_opt.n_runs, [&]( MyIt first, MyIt last ){
+                sa::quickselect( first, first+(k-1), last, compare );
+            }, nth_ok );
+            double intro_ns = mean_ns( scenariosSet, run_opt.n_runs, [&]( MyIt first, MyIt last ){
+                sa::introselect( first, first+(k-1), last, compare );
+            }, nth_ok );
+            double partial_ns = mean_ns( scenariosSet, run_opt.n_runs, [&]( MyIt first, MyIt last ){
+                sa::partial_sort( first, first+k, last, compare );
+            }, prefix_ok );
+            double heap_ns = mean_ns( scenariosSet, run_opt.n_runs, [&]( MyIt first, MyIt last ){
+                result = sa::top_k( first, last, k, compare );
+            }, result_ok );
+
+            bodyFile << "\n" << k << "," << std::fixed << std::setprecision(PRECISION)
+                     << full_ns << "," << quick_ns << "," << intro_ns << "," << partial_ns << "," << heap_ns;
+        }
+
+        std::ofstream file( "data/selection_" + scenariosSet.name() + ".csv" );
+        file << bodyFile.str();
+        file.close();
+
+        std::cout << scenariosSet.name() << "\n" << bodyFile.str() << "\n";
+
+        scenariosSet.next();
+    }
+
+    return 0;
+}